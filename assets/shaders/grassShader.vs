@@ -5,24 +5,54 @@ layout(location = 0) in vec3 vertexPosition;
 layout(location = 1) in vec2 vertexTexCoord;
 layout(location = 2) in vec3 vertexNormal;
 
-// Instance transform matrix (mat4 uses 4 consecutive locations: 3,4,5,6)
-layout(location = 3) in mat4 instanceTransform;
+// Packed instance (PackedGrassInstance): chunk-local x, biased y, z and
+// RGB565 colour as raw unsigned shorts
+layout(location = 3) in vec4 instancePacked;
 
-// Per-instance blade color + diffuse (vec4: RGB + diffuse factor)
-layout(location = 7) in vec4 instanceColorDiffuse;
+// Per-instance height scale, diffuse, temperature, lean (unorm8)
+layout(location = 4) in vec4 instanceAttribs;
 
-// Per-instance temperature for biome blending
-layout(location = 8) in float instanceTemperature;
+// Per-instance stiffness, height jitter, dirt distance, unused (unorm8)
+layout(location = 5) in vec4 instanceExtra;
 
 // Uniforms
 uniform mat4 mvp;
 uniform float time;
+uniform vec2 chunkOrigin;  // World x/z the instance positions are relative to
+uniform float bladeCount;  // Instances the chunk holds (the draw may use fewer)
+
+// Distance LOD: blades are stored in a stratified order, so a blade's rank
+// (instance id / bladeCount) says how early it drops out as density falls.
+// Density is lodReduction^level with one level per lodSpacing, capped at
+// lodMaxLevel; the CPU draws the density of the chunk's nearest point.
+uniform float lodSpacing;
+uniform float lodReduction;
+uniform float lodMaxLevel;
+uniform float fadeStart;
+uniform float fadeEnd;
 uniform vec3 viewPos;  // Camera position for billboarding
 
+// Blade height: baseHeightScale * (1 - heightVariation/2 + jitter * heightVariation)
+// times the instance's biome/erosion factor
+uniform float baseHeightScale;
+uniform float heightVariation;
+
+// Tint toward dirtBlendColor within dirtBlendDistance tiles of dirt-like tiles
+uniform vec3 dirtBlendColor;
+uniform float dirtBlendDistance;
+uniform float dirtBlendStrength;
+
 // Wind parameters
 uniform float windStrength;
 uniform vec2 windDirection;
 
+// Must match PackedGrassInstance
+const float POSITION_SCALE = 1024.0;
+const float HEIGHT_UNITS = 64.0;
+const float HEIGHT_BIAS = 32768.0;
+const float MAX_HEIGHT_SCALE = 4.0;
+const float MAX_DIRT_DISTANCE = 6.0;
+
 // Output to fragment shader
 out vec2 fragTexCoord;
 out vec3 fragWorldPos;
@@ -37,8 +67,22 @@ void main()
     // Get the height factor from texture coord (0 at base, 1 at tip)
     fragHeightFactor = vertexTexCoord.y;
     
-    // Get base position from instance transform (translation component)
-    vec3 basePos = vec3(instanceTransform[3][0], instanceTransform[3][1], instanceTransform[3][2]);
+    // Decode the base position from chunk-local fixed point
+    vec3 basePos = vec3(chunkOrigin.x + instancePacked.x / POSITION_SCALE,
+                        (instancePacked.y - HEIGHT_BIAS) / HEIGHT_UNITS,
+                        chunkOrigin.y + instancePacked.z / POSITION_SCALE);
+    float heightScale = instanceAttribs.x * MAX_HEIGHT_SCALE * baseHeightScale *
+                        (1.0 - heightVariation * 0.5 + instanceExtra.y * heightVariation);
+    
+    // Thin continuously with distance: blades just below the density cut
+    // shrink away instead of popping. The band closes at full density.
+    float dist = length(basePos.xz - viewPos.xz);
+    float density = pow(lodReduction, min(dist / max(lodSpacing, 0.001), lodMaxLevel));
+    float rank = (float(gl_InstanceID) + 0.5) / max(bladeCount, 1.0);
+    float band = max(0.25 * density * (1.0 - density), 0.0001);
+    float keep = clamp((density - rank) / band, 0.0, 1.0);
+    float fade = 1.0 - smoothstep(fadeStart, fadeEnd, dist);
+    heightScale *= keep * fade;  // Zero height leaves a degenerate triangle
     
     // Billboard: rotate blade to face camera (in XZ plane for isometric)
     vec3 toCamera = normalize(vec3(viewPos.x - basePos.x, 0.0, viewPos.z - basePos.z));
@@ -47,7 +91,7 @@ void main()
     // Apply billboard rotation to vertex position
     vec3 billboardPos = basePos;
     billboardPos += right * vertexPosition.x;
-    billboardPos.y += vertexPosition.y;
+    billboardPos.y += vertexPosition.y * heightScale;
     
     vec4 worldPos = vec4(billboardPos, 1.0);
     
@@ -68,9 +112,20 @@ void main()
     
     fragWorldPos = worldPos.xyz;
     fragTexCoord = vertexTexCoord;
-    fragBladeColor = instanceColorDiffuse.rgb;
-    fragDiffuse = instanceColorDiffuse.a;  // Pre-computed diffuse from CPU
-    fragTemperature = instanceTemperature;  // Pass temperature to fragment shader
+    // RGB565 unpack
+    float c = instancePacked.w;
+    fragBladeColor = vec3(floor(c / 2048.0) / 31.0,
+                          mod(floor(c / 32.0), 64.0) / 63.0,
+                          mod(c, 32.0) / 31.0);
+    // Smoothstep falloff from dirt-like tiles
+    float dirtDist = instanceExtra.z * MAX_DIRT_DISTANCE;
+    if (dirtDist < dirtBlendDistance) {
+        float t = dirtDist / dirtBlendDistance;
+        float dirtBlend = (1.0 - t * t * (3.0 - 2.0 * t)) * dirtBlendStrength;
+        fragBladeColor = mix(fragBladeColor, dirtBlendColor, dirtBlend);
+    }
+    fragDiffuse = instanceAttribs.y;  // Pre-computed diffuse from CPU
+    fragTemperature = instanceAttribs.z;  // Pass temperature to fragment shader
     
     gl_Position = mvp * worldPos;
 }
@@ -0,0 +1,21 @@
+#version 330
+
+// Input from vertex shader
+in vec3 fragNormal;
+in vec3 fragColor;
+
+// Output
+out vec4 finalColor;
+
+// Lighting uniforms (same as terrain)
+uniform vec3 sunDirection;
+uniform vec3 sunColor;
+uniform float ambientStrength;
+uniform vec3 ambientColor;
+
+void main()
+{
+    float diff = max(dot(normalize(fragNormal), normalize(sunDirection)), 0.0);
+    vec3 lighting = ambientStrength * ambientColor + diff * sunColor;
+    finalColor = vec4(fragColor * lighting, 1.0);
+}
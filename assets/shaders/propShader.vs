@@ -0,0 +1,77 @@
+#version 330
+
+// Shared prop mesh (PropMeshes), explicit locations to match PropField's VAOs
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in float vertexTint;  // 1 = instance colour, 0 = trunkColor
+
+// Packed instance (PackedPropInstance): chunk-local x, biased y, z and
+// RGB565 colour as raw unsigned shorts
+layout(location = 3) in vec4 instancePacked;
+
+// Per-instance scale, yaw, stretch, unused (unorm8)
+layout(location = 4) in vec4 instanceAttribs;
+
+// Uniforms
+uniform mat4 mvp;
+uniform vec2 chunkOrigin;     // World x/z the instance positions are relative to
+uniform float instanceCount;  // Instances of this type the chunk holds
+uniform vec3 viewPos;
+uniform vec3 trunkColor;
+
+// Distance LOD: instances are stored in random order, so an instance's rank
+// (instance id / instanceCount) says how early it drops out as density falls
+// from 1 at lodStart to 0 at lodEnd. The CPU draws the density of the
+// chunk's nearest point.
+uniform float lodStart;
+uniform float lodEnd;
+
+// Must match PackedPropInstance
+const float POSITION_SCALE = 1024.0;
+const float HEIGHT_UNITS = 64.0;
+const float HEIGHT_BIAS = 32768.0;
+const float MAX_SCALE = 4.0;
+const float MAX_STRETCH = 2.0;
+const float PI = 3.14159265;
+
+// Output to fragment shader
+out vec3 fragNormal;
+out vec3 fragColor;
+
+void main()
+{
+    // Decode the base position from chunk-local fixed point
+    vec3 basePos = vec3(chunkOrigin.x + instancePacked.x / POSITION_SCALE,
+                        (instancePacked.y - HEIGHT_BIAS) / HEIGHT_UNITS,
+                        chunkOrigin.y + instancePacked.z / POSITION_SCALE);
+
+    // Props just below the density cut shrink away instead of popping
+    float dist = length(basePos.xz - viewPos.xz);
+    float density = 1.0 - clamp((dist - lodStart) / max(lodEnd - lodStart, 0.001), 0.0, 1.0);
+    float rank = (float(gl_InstanceID) + 0.5) / max(instanceCount, 1.0);
+    float band = max(0.25 * density * (1.0 - density), 0.0001);
+    float keep = clamp((density - rank) / band, 0.0, 1.0);
+
+    float scale = instanceAttribs.x * MAX_SCALE * keep;
+    float stretch = instanceAttribs.z * MAX_STRETCH;
+    float yaw = instanceAttribs.y * 2.0 * PI;
+    float s = sin(yaw);
+    float c = cos(yaw);
+    mat2 rotation = mat2(c, s, -s, c);
+
+    vec3 local = vertexPosition * vec3(scale, scale * stretch, scale);
+    local.xz = rotation * local.xz;
+    // Stretching y scales normals by the inverse
+    vec3 normal = vertexNormal * vec3(1.0, 1.0 / max(stretch, 0.01), 1.0);
+    normal.xz = rotation * normal.xz;
+    fragNormal = normalize(normal);
+
+    // RGB565 unpack
+    float p = instancePacked.w;
+    vec3 instanceColor = vec3(floor(p / 2048.0) / 31.0,
+                              mod(floor(p / 32.0), 64.0) / 63.0,
+                              mod(p, 32.0) / 31.0);
+    fragColor = mix(trunkColor, instanceColor, vertexTint);
+
+    gl_Position = mvp * vec4(basePos + local, 1.0);
+}
@@ -1,6 +1,11 @@
 #version 330
 
 // Input vertex attributes
+// Float meshes (machine models) use raylib's standard layout. Packed terrain
+// meshes (see PackedTerrainVertex) reuse the same locations:
+//   vertexPosition = int16 x, y, z in quarter units
+//   vertexTexCoord = atlas cell index, corner bits (bit 0 = u max, bit 1 = v max)
+//   vertexNormal.xy = octahedral-encoded normal (snorm8)
 in vec3 vertexPosition;
 in vec2 vertexTexCoord;
 in vec3 vertexNormal;
@@ -10,6 +15,7 @@ in vec4 vertexColor;  // RGBA with erosion in alpha
 uniform mat4 mvp;
 uniform mat4 matModel;
 uniform mat4 matNormal;
+uniform int packedVertices;  // 1 = packed terrain layout, 0 = float layout
 
 // Output vertex attributes (to fragment shader)
 out vec2 fragTexCoord;
@@ -17,18 +23,46 @@ out vec3 fragNormal;
 out vec3 fragPosition;
 out vec4 fragColor;  // Pass erosion data to fragment shader
 
+// Packed layout constants (must match PackedTerrainVertex and textureAtlas.hpp)
+const float POSITION_SCALE = 4.0;
+const float ATLAS_COLUMNS = 5.0;
+const vec2 ATLAS_CELL_UV = vec2(16.0 / 80.0, 16.0 / 16.0);
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.y += (n.y >= 0.0) ? -t : t;
+    return normalize(n);
+}
+
 void main()
 {
+    vec3 position = vertexPosition;
+    vec3 normal = vertexNormal;
+    vec2 texCoord = vertexTexCoord;
+
+    if (packedVertices == 1) {
+        position = vertexPosition / POSITION_SCALE;
+        normal = octDecode(vertexNormal.xy);
+
+        float cell = vertexTexCoord.x;
+        float corner = vertexTexCoord.y;
+        vec2 cellOrigin = vec2(mod(cell, ATLAS_COLUMNS), floor(cell / ATLAS_COLUMNS));
+        vec2 cornerOffset = vec2(mod(corner, 2.0), floor(corner / 2.0));
+        texCoord = (cellOrigin + cornerOffset) * ATLAS_CELL_UV;
+    }
+
     // Send vertex attributes to fragment shader
-    fragTexCoord = vertexTexCoord;
+    fragTexCoord = texCoord;
     fragColor = vertexColor;  // Pass through erosion in alpha channel
-    
+
     // Transform normal to world space
-    fragNormal = normalize(vec3(matNormal * vec4(vertexNormal, 0.0)));
-    
+    fragNormal = normalize(vec3(matNormal * vec4(normal, 0.0)));
+
     // Transform vertex position to world space
-    fragPosition = vec3(matModel * vec4(vertexPosition, 1.0));
-    
+    fragPosition = vec3(matModel * vec4(position, 1.0));
+
     // Calculate final vertex position
-    gl_Position = mvp * vec4(vertexPosition, 1.0);
+    gl_Position = mvp * vec4(position, 1.0);
 }
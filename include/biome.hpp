@@ -53,6 +53,15 @@ struct GrassProps {
     Vector3 baseColor;         // Grass base color
 };
 
+// Scattered prop densities: fraction of Poisson-disk sites that get a prop
+// (see PropField). Tile potentials add to or scale these.
+struct ScatterProps {
+    float rockDensity;
+    float shrubDensity;
+    float treeDensity;
+    float crystalDensity;
+};
+
 // Complete biome definition
 struct BiomeData {
     BiomeType type;
@@ -64,6 +73,9 @@ struct BiomeData {
     // Grass configuration
     GrassProps grass;
     
+    // Rocks, shrubs, trees and crystals
+    ScatterProps scatter;
+    
     // Terrain generation parameters
     float heightMultiplier;    // Scale base height
     float heightOffset;        // Add/subtract from base
@@ -1,39 +1,99 @@
 #ifndef CHUNK_HPP
 #define CHUNK_HPP
 
+#include <atomic>
 #include "tileGrid.hpp"
 #include "grass.hpp"
+#include "meshData.hpp"
+#include "meshUploadQueue.hpp"
+#include "chunkCache.hpp"
 
 #define CHUNKSIZE 32
 
+// Streaming lifecycle of a chunk. The first two transitions run on a worker
+// thread, the upload on the main thread.
+enum class ChunkState : uint8_t {
+    REQUESTED,  // Allocated, waiting for a worker
+    DATA,       // Terrain generated
+    MESHED,     // CPU mesh data built, waiting for upload
+    UPLOADED    // Meshes on the GPU
+};
+
 class Chunk {
     public:
+        // Only allocates; generateTerrain() and buildMesh() fill the chunk
+        // (possibly on a worker thread), uploadMesh() or the jobs from
+        // queueUploads() put it on the GPU
         Chunk(int x, int y);
         ~Chunk();
+        // Back to REQUESTED for reuse by chunkManager's pool. Tile storage,
+        // CPU mesh buffers and GPU buffers are kept for the next chunk (main thread)
+        void reset();
+        // Move a reset chunk to another origin before generating it
+        void setOrigin(int x, int y);
+        // Generate, build and upload terrain immediately (main thread)
         void generateMesh();
         void updateMesh();
 
+        // Worker stages: tile data from the WorldMap, then CPU mesh data
+        void generateTerrain();
+        // Tile data from a warm-cache entry instead of the WorldMap (falls
+        // back to generateTerrain() if the entry cannot be decoded)
+        void restoreTerrain(const CompressedTiles& data);
+        void buildMesh();
+        // GL stage: upload everything buildMesh() produced (main thread)
+        void uploadMesh();
+        // Queue the GL stage as a budgeted job (terrain + water together)
+        void queueUploads(MeshUploadQueue& queue);
+
+        // Grass is not part of the mesh stages: chunkManager builds it only
+        // for chunks near the camera and frees it again when they move away.
+        // Point a view at the tiles blade placement reads (main thread; plan
+        // the build before the tiles can change) and note the grass revision
+        uint32_t viewGrassTiles(GrassTileView& out);
+        // Upload blades planned at revision; false (and nothing uploaded)
+        // if an edit since then made them stale
+        bool uploadGrass(const GrassInstanceData& data, uint32_t revision);
+        // Free the grass instance buffer
+        void releaseGrass();
+        bool hasGrass() const { return grassLoaded; }
+        ChunkState getState() const { return state.load(); }
+        // World-space box around everything the chunk draws (terrain, the
+        // seam walls it owns, water, grass and props)
+        BoundingBox getBounds() const;
+        bool isUploaded() const { return getState() == ChunkState::UPLOADED; }
+
         void render();
-        // Draw only opaque terrain
-        void renderTerrain();
+        // Queue opaque terrain at a detail level (see TERRAIN_LOD_LEVELS) for
+        // the next TerrainArenas::draw(frame), which draws it with its region
+        void markTerrain(int lod, uint32_t frame);
         // Draw only transparent water layer
         void renderWater();
-        // Draw grass layer
-        void renderGrass(float time);
-        void renderWires();
+        // Draw grass layer; density is the fraction of blades to draw
+        void renderGrass(float time, float density = 1.0f);
         // Draw only water wireframe
         void renderWaterWires();
         void renderDataPoint();
 
         tileGrid tiles;
         GrassField grass;
+        // Rocks, shrubs, trees and crystals; built with the mesh stages
+        PropField props;
         Texture2D textureAtlas;
-        Model model;
         Mesh mesh;
+        // Frame number of the last chunkManager::cullChunks() that kept the chunk
+        uint32_t visibleFrame = 0;
     private:
         int chunkX, chunkY;
-        bool meshGenerated;
-        
+        std::atomic<ChunkState> state{ChunkState::REQUESTED};
+        // Built mesh data waiting for upload; kept across reset() so the
+        // next build fills the same allocations
+        ChunkMeshData pendingMesh;
+        bool meshPending = false;
+        bool grassLoaded = false;
+        uint32_t grassRevision = 0;  // Bumped by edits that change blade placement
+
+        void uploadTerrain();
         void generateGrassData();
 };
 
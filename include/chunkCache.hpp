@@ -0,0 +1,74 @@
+#ifndef CHUNKCACHE_HPP
+#define CHUNKCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "tileGrid.hpp"
+
+// Tile data of one chunk in ChunkCache's compressed format
+struct CompressedTiles {
+    std::vector<uint8_t> bytes;  // PackBits stream
+    uint32_t rawSize = 0;        // Size of the stream once unpacked
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    bool empty() const { return bytes.empty(); }
+};
+
+/**
+ * ChunkCache - Warm cache of recently unloaded chunks' tile data
+ *
+ * An unloaded chunk's tiles are stored compactly so that coming back to it
+ * restores the tiles (including edits) without querying the WorldMap. The
+ * per-tile byte fields are laid out as planes, corner heights are quantized
+ * to quarter units (the precision of PackedTerrainVertex) and delta coded,
+ * and the whole stream is run-length encoded with PackBits. Machine
+ * occupancy is not cached.
+ *
+ * Entries are evicted least-recently-stored first once the byte budget is
+ * exceeded. The cache itself is main-thread only; compress()/decompress()
+ * touch nothing but their arguments and may run on a worker.
+ */
+class ChunkCache {
+public:
+    explicit ChunkCache(size_t maxBytes = 4 * 1024 * 1024) : maxBytes(maxBytes) {}
+
+    static void compress(tileGrid& grid, CompressedTiles& out);
+    // False if the data is corrupt or does not match the grid size
+    static bool decompress(const CompressedTiles& in, tileGrid& grid);
+
+    // Store (or replace) the entry for key, evicting old entries as needed
+    void insert(uint64_t key, CompressedTiles&& data);
+    // Move the entry for key into out and remove it; counts a hit or miss
+    bool take(uint64_t key, CompressedTiles& out);
+    void clear();
+
+    size_t getEntryCount() const { return entries.size(); }
+    size_t getBytes() const { return bytes; }
+    // Uncompressed size of the cached entries, for the compression ratio
+    size_t getRawBytes() const { return rawBytes; }
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+    double getHitRate() const { return hits + misses > 0 ? (double)hits / (hits + misses) : 0.0; }
+
+private:
+    struct Entry {
+        CompressedTiles data;
+        std::list<uint64_t>::iterator order;
+    };
+
+    void erase(std::unordered_map<uint64_t, Entry>::iterator it);
+
+    std::unordered_map<uint64_t, Entry> entries;
+    std::list<uint64_t> order;  // Oldest first
+    size_t maxBytes;
+    size_t bytes = 0;
+    size_t rawBytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+#endif // CHUNKCACHE_HPP
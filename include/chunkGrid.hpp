@@ -0,0 +1,147 @@
+#ifndef CHUNKGRID_HPP
+#define CHUNKGRID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "chunk.hpp"
+
+struct ChunkCoord {
+    int x;
+    int y;
+    bool operator==(const ChunkCoord& other) const { return x == other.x && y == other.y; }
+};
+
+namespace std {
+    template<>
+    struct hash<ChunkCoord> {
+        // Both coordinates packed into 64 bits and mixed (MurmurHash3
+        // finalizer), so neighbouring and diagonal chunks do not collide
+        size_t operator()(const ChunkCoord& coord) const noexcept {
+            uint64_t k = (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.y);
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdULL;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ULL;
+            k ^= k >> 33;
+            return static_cast<size_t>(k);
+        }
+    };
+}
+
+/**
+ * ChunkGrid - Toroidal array of the loaded chunks
+ *
+ * A square of side 2 * halfExtent + 1 slots; chunk (x, y) lives in slot
+ * (x mod side, y mod side). Any square of chunks of that side maps onto the
+ * slots one to one, so as long as the loaded chunks stay within such a
+ * square around the camera, lookup is one index computation and nothing
+ * moves when the camera does: the slots vacated on one edge are the ones the
+ * newly exposed edge fills. Iteration walks the slot array in memory order.
+ */
+class ChunkGrid {
+public:
+    struct Slot {
+        ChunkCoord coord = {0, 0};
+        std::unique_ptr<Chunk> chunk;  // Empty slot if null
+    };
+
+    explicit ChunkGrid(int halfExtent);
+
+    int getSide() const { return side; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Chunk* find(const ChunkCoord& coord) const {
+        const Slot& slot = slots[indexOf(coord)];
+        return slot.chunk && slot.coord == coord ? slot.chunk.get() : nullptr;
+    }
+    bool contains(const ChunkCoord& coord) const { return find(coord) != nullptr; }
+    // The slot coord maps to, whichever chunk (if any) it holds
+    Slot& slotFor(const ChunkCoord& coord) { return slots[indexOf(coord)]; }
+
+    // Store a chunk; its slot must be empty
+    void insert(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk);
+    // Remove and return the chunk at coord (null if not loaded)
+    std::unique_ptr<Chunk> take(const ChunkCoord& coord);
+    void clear();
+
+    // Visit the occupied slots of the rows and columns the square around
+    // from no longer covers once centred on to: only the edges that moved
+    // out, or every slot after a jump of a whole square. A slot may be
+    // visited twice; fn sees it empty the second time if it took the chunk.
+    template <typename Fn>
+    void forEachLeaving(const ChunkCoord& from, const ChunkCoord& to, Fn&& fn);
+
+    template <typename SlotT>
+    class Iterator {
+    public:
+        Iterator(SlotT* cur, SlotT* end) : cur(cur), end(end) { skipEmpty(); }
+        SlotT& operator*() const { return *cur; }
+        SlotT* operator->() const { return cur; }
+        Iterator& operator++() {
+            ++cur;
+            skipEmpty();
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return cur != other.cur; }
+
+    private:
+        void skipEmpty() {
+            while (cur != end && !cur->chunk) ++cur;
+        }
+        SlotT* cur;
+        SlotT* end;
+    };
+
+    // Occupied slots only
+    Iterator<Slot> begin() { return {slots.data(), slots.data() + slots.size()}; }
+    Iterator<Slot> end() { return {slots.data() + slots.size(), slots.data() + slots.size()}; }
+    Iterator<const Slot> begin() const { return {slots.data(), slots.data() + slots.size()}; }
+    Iterator<const Slot> end() const { return {slots.data() + slots.size(), slots.data() + slots.size()}; }
+
+private:
+    int wrap(int c) const {
+        int m = c % side;
+        return m < 0 ? m + side : m;
+    }
+    size_t indexOf(const ChunkCoord& coord) const { return (size_t)wrap(coord.y) * side + wrap(coord.x); }
+
+    int halfExtent;
+    int side;
+    std::vector<Slot> slots;  // Row-major, side x side
+    size_t count = 0;
+};
+
+template <typename Fn>
+void ChunkGrid::forEachLeaving(const ChunkCoord& from, const ChunkCoord& to, Fn&& fn) {
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    if (std::abs(dx) >= side || std::abs(dy) >= side) {
+        for (Slot& slot : slots) {
+            if (slot.chunk) fn(slot);
+        }
+        return;
+    }
+
+    // Columns, then rows, of the old square on the side the centre moved away from
+    for (int i = 0; i < std::abs(dx); ++i) {
+        int col = wrap(dx > 0 ? from.x - halfExtent + i : from.x + halfExtent - i);
+        for (int row = 0; row < side; ++row) {
+            Slot& slot = slots[(size_t)row * side + col];
+            if (slot.chunk) fn(slot);
+        }
+    }
+    for (int i = 0; i < std::abs(dy); ++i) {
+        int row = wrap(dy > 0 ? from.y - halfExtent + i : from.y + halfExtent - i);
+        for (int col = 0; col < side; ++col) {
+            Slot& slot = slots[(size_t)row * side + col];
+            if (slot.chunk) fn(slot);
+        }
+    }
+}
+
+#endif // CHUNKGRID_HPP
@@ -3,51 +3,246 @@
 
 #include <unordered_map>
 #include <memory>
+#include <deque>
+#include <vector>
+#include <atomic>
 #include "chunk.hpp"
+#include "chunkGrid.hpp"
+#include "meshUploadQueue.hpp"
+#include "workerPool.hpp"
+#include "culling.hpp"
 #include "raylib.h"
 
-struct ChunkCoord {
-    int x;
-    int y;
-    bool operator==(const ChunkCoord& other) const { return x == other.x && y == other.y; }
-};
-
-namespace std {
-    template<>
-    struct hash<ChunkCoord> {
-        size_t operator()(const ChunkCoord& coord) const noexcept {
-            return (std::hash<int>()(coord.x) << 1) ^ std::hash<int>()(coord.y);
-        }
-    };
-}
-
 class chunkManager {
 public:
     explicit chunkManager(int loadRadius = 2);
     ~chunkManager();
 
     void update(const Camera& cam);
+    // Decide which chunks the render passes draw: frustum culling against
+    // the active camera, plus the optional horizon test. Call once per frame
+    // between BeginMode3D and the first render pass.
+    void cullChunks();
+    // Frustum (and horizon, if enabled) test for other world-space objects
+    bool isVisible(const BoundingBox& box) const;
+    void setHorizonCulling(bool enabled) { horizonCulling = enabled; }
+    bool getHorizonCulling() const { return horizonCulling; }
+    // Terrain detail by camera distance to a chunk's box: the full tile mesh
+    // up to the level 1 distance, then one coarser level past each distance
+    void setTerrainLod(bool enabled) { lodEnabled = enabled; }
+    bool getTerrainLod() const { return lodEnabled; }
+    float getLodDistance(int level) const { return lodDistances[level - 1]; }
+    void setLodDistance(int level, float distance) { lodDistances[level - 1] = distance; }
+    struct CullStats {
+        int drawn = 0;
+        int frustumCulled = 0;
+        int horizonCulled = 0;
+        int lodChunks[TERRAIN_LOD_LEVELS] = {};  // Drawn chunks per detail level
+        int terrainVertices = 0;                 // Terrain vertices submitted
+        int terrainDrawCalls = 0;                // Merged draws over all regions
+        int64_t grassBlades = 0;                 // Instances submitted by renderGrass()
+        int64_t props = 0;                       // Instances submitted by renderProps()
+        int propDraws = 0;                       // Instanced draws (one per chunk and prop type)
+    };
+    const CullStats& getCullStats() const { return cullStats; }
+
     void render();
-    void renderGrass(float time, const Camera& cam);  // Render grass for all chunks (with distance culling)
+    void renderGrass(float time, const Camera& cam);  // Render grass of visible chunks within GrassSettings::renderDistance
+    void renderProps(const Camera& cam);  // Render rocks, shrubs, trees and crystals of visible chunks
     void renderWires();
     void renderDataPoint(Color a, Color b, uint8_t tile::*dataMember);
+    // Loaded chunk at chunk coordinates, or nullptr; never generates
     Chunk* getChunk(int cx, int cy);
+    // Generate and upload a chunk synchronously if it is not loaded yet
+    // (startup only: this blocks the main thread)
+    Chunk* loadChunkNow(int cx, int cy);
     // Ray-pick across loaded chunks around camera; returns (globalX, globalZ, localHeight) or (-1,-1,-1) if none
     Vector3 pickTile(const Ray& ray, const Camera& cam);
+    // Walk chunks along the ray (2D DDA) and pick the first terrain hit in
+    // world space; hit.x/hit.y are global tile coordinates
+    bool raycastTile(const Ray& ray, TileHit& hit, Chunk** hitChunk = nullptr);
+    // Cast rayCount rays across the screen from cam and return picks per second
+    double benchmarkPicking(const Camera& cam, int rayCount);
     
     // Clear all loaded chunks (for regeneration)
     void clearAllChunks();
+
+    // Time chunk lookups and a full walk of the loaded chunks, in ns per
+    // lookup / per visited chunk, against an unordered_map holding the same
+    // chunks (the container used before ChunkGrid)
+    struct ContainerBenchmark {
+        double gridLookupNs = 0.0;
+        double mapLookupNs = 0.0;
+        double gridIterateNs = 0.0;
+        double mapIterateNs = 0.0;
+    };
+    ContainerBenchmark benchmarkChunkAccess(int iterations);
     
     // Get total grass blade count across all chunks
     size_t getTotalGrassBlades() const;
+    // Grass instance buffer memory across loaded chunks
+    size_t getGrassGpuBytes() const;
+    // Chunks holding grass / grass builds not yet uploaded
+    size_t getGrassChunkCount() const;
+    size_t getPendingGrassCount() const { return grassPending.size(); }
+
+    size_t getChunkCount() const { return chunks.size(); }
+    // Terrain GPU memory across loaded chunks (packed vertices, incl. seams)
+    size_t getTerrainGpuBytes() const;
+    size_t getTerrainVertexCount() const;
+    // Average milliseconds per chunk to emit and pack terrain vertices,
+    // with or without the normal table
+    double benchmarkPacking(int iterations, bool normalTable);
+
+    // New chunks are built on the CPU and uploaded over several frames
+    MeshUploadQueue& getUploadQueue() { return uploads; }
+    // Chunks requested but not yet handed back by a worker
+    size_t getPendingChunkCount() const { return pending.size(); }
+    const WorkerPool& getWorkers() const { return workers; }
+    // Unloaded chunks: reset and ready for reuse / waiting to be reset
+    size_t getPooledChunkCount() const { return chunkPool.size(); }
+    size_t getRetiringChunkCount() const { return retiring.size(); }
+    // Compressed tile data of recently unloaded chunks
+    const ChunkCache& getWarmCache() const { return warmCache; }
 
 private:
-    Chunk* ensureChunk(int cx, int cy);
+    // A chunk being generated in the background. Shared with the worker so
+    // a cancelled job can finish its current stage without dangling.
+    struct ChunkJob {
+        ChunkCoord coord;
+        std::unique_ptr<Chunk> chunk;
+        CompressedTiles cached;  // Warm-cache entry the worker restores from
+        bool warm = false;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+        std::atomic<bool> settled{false};  // The worker is done with the chunk
+    };
+
+    // Grass for one chunk, planned from its tiles on the main thread and
+    // placed by workers from the plan. The workers never touch the chunk, so
+    // a cancelled job can simply be forgotten.
+    struct GrassJob {
+        GrassBuildPlan plan;
+        GrassInstanceData data;
+        uint32_t revision = 0;   // Chunk grass revision the plan was made at
+        bool queued = false;     // Upload pushed (main thread only)
+        std::atomic<int> remaining{0};  // Row bands still being placed
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+    };
+
+    // Unloaded chunks are recycled instead of destroyed: their tile storage
+    // and GPU buffers are refilled by the next chunk. Resetting (or, beyond
+    // the pool size, destroying) them is spread over frames.
+    // Chunks that were in the world have their tiles compressed into the
+    // warm cache before the reset.
+    struct RetiredChunk {
+        ChunkCoord coord;
+        std::unique_ptr<Chunk> chunk;
+        bool cacheTiles;
+    };
+    static constexpr int RETIRE_PER_FRAME = 2;
+    // Hysteresis: chunks load within radius but only unload beyond
+    // radius + UNLOAD_MARGIN, so pacing across a chunk border does not churn
+    static constexpr int UNLOAD_MARGIN = 1;
+    // Grass is built for uploaded chunks within GrassSettings::renderDistance
+    // (XZ, camera to chunk edge) and freed beyond it plus this margin
+    static constexpr float GRASS_RELEASE_MARGIN = 16.0f;
+    // Tile rows per grass placement job; a chunk's build spreads over
+    // CHUNKSIZE / GRASS_ROWS_PER_BAND workers
+    static constexpr int GRASS_ROWS_PER_BAND = 8;
+    size_t poolCapacity() const { return 2 * (2 * radius + 1); }  // One row of chunks each way
+    std::unique_ptr<Chunk> acquireChunk(const ChunkCoord& coord);
+    void retireChunk(std::unique_ptr<Chunk> chunk, const ChunkCoord& coord, bool cacheTiles);
+    void processRetired();
+    // Cache (if wanted) and reset a retired chunk
+    void recycleChunk(RetiredChunk& retired);
+    // Cache a still-retiring chunk's tiles now, before coord is requested again
+    void flushRetired(const ChunkCoord& coord);
+    bool outsideBand(const ChunkCoord& coord, const ChunkCoord& center) const;
+    int selectLod(const BoundingBox& bounds) const;
+    // Mark the visible chunks' terrain and draw it region by region
+    void renderTerrainBatched();
+
+    // Queue generation of a chunk that is neither loaded nor pending
+    void requestChunk(const ChunkCoord& coord);
+    void cancelJob(const ChunkCoord& coord);
+    void cancelDistant(const ChunkCoord& center);
+    // Move chunks finished by workers into the world and queue their uploads
+    void collectFinished();
+    // Higher runs sooner: near chunks first, those ahead of the camera before those behind
+    float chunkPriority(const ChunkCoord& coord) const;
+    void installChunk(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk);
     void unloadDistant(const ChunkCoord& center);
+    // Wire/unwire tileGrid::neighborChunks between a chunk and its loaded D8 neighbours
+    void linkNeighbors(const ChunkCoord& coord, Chunk* chunk);
+    void unlinkNeighbors(const ChunkCoord& coord);
+    // Unlink a loaded chunk and hand it to the retire queue
+    void unloadChunk(const ChunkCoord& coord);
+    // Request, upload and free grass as chunks cross the grass radius
+    void updateGrass();
+    void requestGrass(const ChunkCoord& coord, Chunk* chunk);
+    void cancelGrass(const ChunkCoord& coord);
+    // Rebuild all grass in the background after a placement setting changed;
+    // the old blades are drawn until the new ones are uploaded
+    void rebuildGrass();
+    // XZ distance from pos to the chunk's square
+    static float chunkDistance(const ChunkCoord& coord, Vector2 pos);
+    // Add or drop a chunk's entry in waterOrder depending on whether it has water now
+    void updateWaterEntry(const ChunkCoord& coord, Chunk* chunk);
+    void removeWaterEntry(const ChunkCoord& coord);
+    // Recompute distances from the camera and restore back-to-front order
+    void sortWaterOrder();
 
-    std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>> chunks;
+    // Sized for the unload band, so every chunk that may stay loaded has
+    // its own slot
+    ChunkGrid chunks;
+    // Chunks that passed cullChunks() this frame
+    struct VisibleChunk {
+        ChunkCoord coord;
+        Chunk* chunk;
+        BoundingBox bounds;
+        int lod = 0;
+    };
+    std::vector<VisibleChunk> visible;
+    Frustum frustum;
+    HorizonBuffer horizon;
+    bool horizonCulling = false;
+    bool horizonActive = false;  // horizon holds this frame's occluders
+    CullStats cullStats;
+    bool lodEnabled = true;
+    float lodDistances[TERRAIN_LOD_LEVELS - 1] = {96.0f, 160.0f};
+    uint32_t cullFrame = 0;  // Stamped on chunks kept by cullChunks()
+    // Chunks with water, farthest first, for the translucent pass. Kept
+    // across frames: entries change on load, unload, water upload and
+    // edits, and distances are only recomputed when the camera changes chunk.
+    struct WaterEntry {
+        ChunkCoord coord;
+        Chunk* chunk;
+        float distSq;  // XZ distance from waterOrigin, squared
+    };
+    std::vector<WaterEntry> waterOrder;
+    Vector2 waterOrigin = {0.0f, 0.0f};  // Camera position at the last sort
+    std::unordered_map<ChunkCoord, std::shared_ptr<ChunkJob>> pending;
+    // Grass builds by chunk; an entry stays until its upload ran
+    std::unordered_map<ChunkCoord, std::shared_ptr<GrassJob>> grassPending;
+    // Placement settings the loaded grass was built with
+    GrassPlacementParams grassPlacement;
+    // Cancelled jobs whose worker may still be using the chunk. They are kept
+    // until settled so a chunk with GL objects is never freed on a worker.
+    std::vector<std::shared_ptr<ChunkJob>> cancelling;
+    std::vector<std::unique_ptr<Chunk>> chunkPool;  // Reset, ready for reuse
+    std::deque<RetiredChunk> retiring;               // Unloaded, not yet reset
+    ChunkCache warmCache;
+    MeshUploadQueue uploads;
     int radius;
     ChunkCoord lastCenter; // last camera chunk to avoid redundant updates
+    // Camera position and XZ forward direction, for request priorities
+    Vector2 viewPos = {0.0f, 0.0f};
+    Vector2 viewDir = {0.0f, 1.0f};
+    Vector3 cameraPos = {0.0f, 0.0f, 0.0f};
+    // Declared last so it is destroyed (and its threads joined) first
+    WorkerPool workers;
 };
 
 #endif // CHUNKMANAGER_HPP
@@ -0,0 +1,60 @@
+#ifndef CULLING_HPP
+#define CULLING_HPP
+
+#include <raylib.h>
+
+/**
+ * Frustum - Six clip planes of a view-projection matrix
+ *
+ * Planes are extracted from the combined matrix (Gribb/Hartmann), so
+ * perspective and orthographic cameras are handled alike. Normals point
+ * into the frustum; planes are not normalized, which the box test does
+ * not need.
+ */
+struct Frustum {
+    Vector4 planes[6] = {};  // All zero: everything passes
+
+    static Frustum fromMatrix(const Matrix& viewProj);
+    // Frustum of the active 3D mode (call between BeginMode3D/EndMode3D)
+    static Frustum fromCurrentMatrices();
+
+    // False only if the box is entirely outside one of the planes
+    bool intersects(const BoundingBox& box) const;
+};
+
+/**
+ * HorizonBuffer - Coarse screen-space occlusion for terrain chunks
+ *
+ * The screen is split into vertical column bins. Each bin keeps one NDC
+ * height interval known to be covered by opaque terrain; a box whose
+ * projection lies inside the covered interval of every bin it spans is
+ * hidden. Chunks are tested front to back and each drawn chunk adds the
+ * top face of its box at the chunk's minimum terrain height as an occluder:
+ * the terrain surface lies on or above that face everywhere, so any ray
+ * reaching it has crossed the terrain first.
+ *
+ * Only meant for cameras above the terrain (the isometric view): the
+ * occluder argument does not hold from below ground.
+ */
+class HorizonBuffer {
+public:
+    static constexpr int BINS = 64;
+
+    // Start an empty buffer for a new view
+    void reset(const Matrix& viewProj);
+
+    // Covered by what has been added so far
+    bool occludes(const BoundingBox& box) const;
+    // Add the horizontal quad [x0, x1] x [z0, z1] at height y as an occluder
+    void addOccluder(float x0, float z0, float x1, float z1, float y);
+
+private:
+    // Project to NDC; false if the point is behind (or on) the near plane
+    bool project(Vector3 p, float& x, float& y) const;
+
+    Matrix viewProj = {0};
+    float coveredLo[BINS] = {};  // A bin is empty while lo > hi (see reset())
+    float coveredHi[BINS] = {};
+};
+
+#endif // CULLING_HPP
@@ -24,7 +24,12 @@ class gameState{
 
     bool buildMode = false;
     bool showVisualSettings = false; // Toggle for unified settings panel
+    bool showProfiler = false;       // Toggle for profiler timers/counters window
     bool shouldRegenerateTerrain = false;  // Flag to trigger regeneration
+    double pickBenchmarkRate = 0.0;        // Last ray-pick benchmark result (picks/s)
+    double packBenchmarkMs = 0.0;          // Last terrain packing benchmark (ms/chunk)
+    double packBenchmarkNoTableMs = 0.0;   // Same, with the normal table disabled
+    chunkManager::ContainerBenchmark chunkAccessBenchmark;  // Last chunk container benchmark
     void init();
     void update();
     void render();
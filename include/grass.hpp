@@ -3,39 +3,127 @@
 
 #include <raylib.h>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include "biome.hpp"
+#include "visualSettings.hpp"
+
+struct GrassInstanceData;
+class tileGrid;
+
+// The chunk tiles blade placement reads, in place: biome data and the tiles'
+// own corner heights come straight from the tile storage, and the dirt field
+// reaches DIRT_BORDER tiles into the neighbours through tileGrid::borderTile.
+// Nothing is copied, so only GrassField::planBuild reads through it, on the
+// thread that owns the tiles; row bands work from the plan alone.
+struct GrassTileView {
+    const tileGrid* tiles = nullptr;
+    int originX = 0;  // World position of the chunk origin
+    int originZ = 0;
+    int width = 0;    // Chunk dimensions in tiles
+    int height = 0;
+
+    // Covers the largest dirt blend distance the settings offer
+    static constexpr int DIRT_BORDER = 6;
+};
+
+// Per-tile terms of blade placement, evaluated once per tile by
+// GrassField::planBuild rather than once per blade
+struct GrassTilePlan {
+    uint32_t first = 0;      // First instance slot of the tile
+    uint16_t count = 0;      // Blades placed; 0 = no grass
+    float dirtDistance = 0.0f;  // Dirt field at the tile centre
+    float heightMult = 0.0f; // Biome and erosion height factor
+    float leanAmount = 0.0f;
+    float temperature = 0.0f;
+    Vector3 color = {0.0f, 0.0f, 0.0f};  // Tip colour before dirt blending
+    // Bilinear height over the tile, fx/fz in [0, 1):
+    // h = h00 + dhdx * fx + dhdz * fz + twist * fx * fz
+    float h00 = 0.0f;
+    float dhdx = 0.0f;
+    float dhdz = 0.0f;
+    float twist = 0.0f;
+};
+
+// Settings blade placement reads. Colours, the dirt blend and blade height
+// are shader uniforms; only a change in these needs the blades rebuilt.
+struct GrassPlacementParams {
+    float bladesPerTile = 0.0f;
+    float minDensity = 0.0f;
+    float slopeReduction = 0.0f;
+    float erosionThreshold = 0.0f;
+    float erosionFullExpose = 0.0f;
+
+    static GrassPlacementParams current();
+    bool operator==(const GrassPlacementParams& other) const {
+        return bladesPerTile == other.bladesPerTile && minDensity == other.minDensity &&
+               slopeReduction == other.slopeReduction && erosionThreshold == other.erosionThreshold &&
+               erosionFullExpose == other.erosionFullExpose;
+    }
+    bool operator!=(const GrassPlacementParams& other) const { return !(*this == other); }
+};
+
+struct GrassBuildPlan {
+    GrassSettings settings;  // Copied so every row band sees the same values
+    std::vector<GrassTilePlan> tiles;
+    std::vector<float> ranks;  // Sort key per instance slot, see finishBuild()
+    int originX = 0;  // From the view, for the per-tile blade seeds
+    int originZ = 0;
+    int width = 0;
+    int height = 0;
+    // Signed distance in tiles from each tile centre of the chunk and a
+    // GrassTileView::DIRT_BORDER wide ring around it to the nearest
+    // grass/dirt-like edge, negative on dirt-like tiles. Blades sample it
+    // bilinearly.
+    std::vector<float> dirtField;
+    int dirtFieldWidth = 0;
+    size_t bladeCount = 0;
+};
 
 /**
- * GrassBlade - Per-instance data for a single grass blade
- * 
- * This is packed efficiently for GPU upload. Each blade needs:
- * - Position (from instance matrix)
- * - Color tint (RGB, derived from biome/temperature/humidity)
- * - Height scale (0-1, affects blade length)
- * - Bend angle (base bend direction for wind)
- * - Phase offset (for wind animation desync, can derive from position)
+ * PackedGrassInstance - 16-byte per-blade instance record (vs. 84 bytes for a
+ * float mat4 + RGBA/diffuse vec4 + temperature)
+ *
+ * The old instance matrix only ever held a translation and a Y scale. The
+ * position is now chunk-local fixed point (x/z in 1/POSITION_SCALE tiles, y in
+ * 1/HEIGHT_UNITS units biased by HEIGHT_BIAS so it fits unsigned), placed by
+ * the chunkOrigin uniform. Colour is RGB565 and the scalar attributes are
+ * unorm8. grassShader.vs decodes this layout.
+ *
+ * Only what depends on the tile and the blade's own random draws is stored:
+ * base height, height variation and the dirt blend are applied in the shader
+ * from GrassSettings uniforms, so changing them needs no rebuild.
  */
-struct GrassBlade {
-    // Position is encoded in the transform matrix
-    // These are per-blade attributes packed for the shader
-    
-    // Color tint (normalized 0-1) + diffuse lighting factor in alpha
-    float r, g, b, diffuse;
-    
-    // Temperature (0-1) for biome color blending in shader
-    float temperature;
-    
-    // Height multiplier (0.5 - 1.5 typical range)
-    float heightScale;
-    
-    // Base angle in radians (which way the blade leans)
-    float baseAngle;
-    
-    // Stiffness (how much it resists wind, 0-1)
-    float stiffness;
+struct PackedGrassInstance {
+    uint16_t position[3];  // x, y (biased), z
+    uint16_t color;        // RGB565 tint
+    uint8_t heightScale;   // Biome and erosion height factor, 0..MAX_HEIGHT_SCALE
+    uint8_t diffuse;       // Pre-computed terrain diffuse
+    uint8_t temperature;   // Tile temperature for biome colour blending
+    uint8_t lean;          // Base lean angle, 128 = upright, +-MAX_LEAN radians
+    uint8_t stiffness;     // Resistance to wind
+    uint8_t heightJitter;  // Height variation draw, 0..1
+    uint8_t dirtDistance;  // Tiles to the nearest dirt-like edge, 0..MAX_DIRT_DISTANCE
+    uint8_t reserved;
+
+    static constexpr float POSITION_SCALE = 1024.0f;  // Chunk-local x/z up to 64 tiles
+    static constexpr float HEIGHT_UNITS = 64.0f;      // y from -512 to +512
+    static constexpr int HEIGHT_BIAS = 32768;
+    static constexpr float MAX_HEIGHT_SCALE = 4.0f;
+    static constexpr float MAX_LEAN = 0.5f;
+    static constexpr float MAX_DIRT_DISTANCE = 6.0f;  // Beyond the largest blend distance
+
+    static PackedGrassInstance pack(float localX, float y, float localZ, float heightScale,
+                                    float heightJitter, Vector3 color, float diffuse,
+                                    float temperature, float lean, float stiffness,
+                                    float dirtDistance);
 };
 
+static_assert(sizeof(PackedGrassInstance) == 16, "PackedGrassInstance must stay 16 bytes");
+
+// Per-blade size of the float layout this replaces (for memory comparisons)
+inline constexpr size_t FLOAT_GRASS_INSTANCE_BYTES = 16 * sizeof(float) + 4 * sizeof(float) + sizeof(float);
+
 /**
  * GrassField - Manages grass instances for a chunk
  * 
@@ -43,38 +131,55 @@ struct GrassBlade {
  * - Generating blade positions and properties from tile data
  * - Building instanced mesh data
  * - Rendering with instancing
+ *
+ * build() only produces CPU instance data and is static; past its planning
+ * stage it may run off the main thread without touching the field or the
+ * tiles. upload() creates the GPU buffers, generate() does both at once. Buffers
+ * are refilled in place when the new instances fit, so a pooled chunk's
+ * grass costs no GL allocations. All instance data lives in one interleaved
+ * buffer of PackedGrassInstance; nothing is kept on the CPU after upload.
  */
 class GrassField {
 public:
     GrassField();
     ~GrassField();
     
-    // Generate grass blades for a chunk based on tile properties
-    // chunkWorldX/Z: world position of chunk origin
-    // width/height: chunk dimensions in tiles
-    // tileHeights: height data for tile corners (width+1 x height+1)
-    // tileData: per-tile biome info (temperature, moisture, type, potentials)
-    // erosionFactors: per-tile erosion intensity (0=none, 255=max erosion)
-    void generate(
-        int chunkWorldX, int chunkWorldZ,
-        int width, int height,
-        const std::vector<float>& tileHeights,
-        const std::vector<BiomeType>& biomes,
-        const std::vector<uint8_t>& temperatures,
-        const std::vector<uint8_t>& moistures,
-        const std::vector<uint8_t>& biologicalPotentials,
-        const std::vector<uint8_t>& erosionFactors
-    );
+    // Build and upload the blades of the viewed tiles at once (main thread)
+    void generate(const GrassTileView& view);
+
+    // Build stage of generate(): fill per-instance data without touching the GPU.
+    // Same as planBuild(), placeRows() over every row, then finishBuild().
+    static void build(GrassInstanceData& out, const GrassTileView& view);
+
+    // The build split into stages so the rows of one chunk can be placed on
+    // several workers. planBuild() reads the tiles, evaluates the per-tile
+    // terms once and sizes out; placeRows() for disjoint row ranges may then
+    // run concurrently on any thread, as each tile writes only its own slots
+    // and nothing but the plan is read; finishBuild() runs once all are done.
+    static void planBuild(GrassBuildPlan& plan, GrassInstanceData& out, const GrassTileView& view);
+    static void placeRows(GrassBuildPlan& plan, GrassInstanceData& out, int rowBegin, int rowEnd);
+    static void finishBuild(GrassBuildPlan& plan, GrassInstanceData& out);
+    // Fill GrassBuildPlan::dirtField from per-cell dirt-like flags of a w x h grid
+    static void buildDirtField(const std::vector<uint8_t>& dirt, int w, int h, std::vector<float>& field);
+
+    // Upload stage: replace the instance data with built data (main thread)
+    void upload(const GrassInstanceData& data);
     
-    // Clear all grass data
+    // Clear all grass data and release the instance buffers
     void clear();
+    // Draw nothing, but keep the instance buffers for the next upload
+    void resetInstances() { bladeCount = 0; }
     
-    // Render all grass blades using instancing
+    // Render grass blades using instancing
     // time: current time for wind animation
-    void render(float time);
+    // density: fraction of the blades to draw. Instances are stored in a
+    // stratified order (see build()), so any prefix is an even subsample.
+    void render(float time, float density = 1.0f);
     
     // Get number of grass blades
     size_t getBladeCount() const { return bladeCount; }
+    // Instance buffer size, including headroom
+    size_t getGpuBytes() const { return vboInstances != 0 ? instanceCapacity * sizeof(PackedGrassInstance) : 0; }
     
     // Configuration - BILLBOARD GRASS (slim blades facing camera)
     static constexpr int BLADES_PER_TILE = 50;  // More blades since they're slimmer
@@ -82,10 +187,8 @@ public:
     static constexpr float BLADE_WIDTH = 0.15f;  // Slim billboards
     
 private:
-    // Instance data
-    std::vector<Matrix> transforms;      // Per-instance transform matrices
-    std::vector<GrassBlade> bladeData;   // Per-instance blade properties
     size_t bladeCount = 0;
+    size_t instanceCapacity = 0;  // Blades the instance buffers can hold
     
     // GPU resources - using raw rlgl for proper instancing control
     Mesh bladeMesh;           // Reference only, we manage VBOs ourselves
@@ -98,21 +201,14 @@ private:
     unsigned int vboPositions = 0;             // Vertex positions VBO
     unsigned int vboTexcoords = 0;             // Texture coordinates VBO
     unsigned int vboNormals = 0;               // Normals VBO
-    unsigned int vboInstanceTransforms = 0;    // Per-instance transforms VBO
-    unsigned int vboInstanceColors = 0;        // Per-instance color+diffuse VBO (vec4)
-    unsigned int vboInstanceTemp = 0;          // Per-instance temperature VBO (float)
+    unsigned int vboInstances = 0;             // Per-instance PackedGrassInstance VBO
     int vertexCount = 0;                       // Number of vertices in blade mesh
+    float originX = 0.0f;                      // World position the instances are relative to
+    float originZ = 0.0f;
     
     // Generate the base blade mesh (a simple quad or triangle strip)
     void generateBladeMesh();
     
-    // Upload instance data to GPU
-    void uploadInstanceData();
-    
-    // Helper: get interpolated height at a position within a tile
-    float getHeightAt(float localX, float localZ, int tileX, int tileZ,
-                      int width, const std::vector<float>& heights) const;
-    
     // Helper: compute grass color from tile properties
     Color computeGrassColor(uint8_t temperature, uint8_t moisture, 
                            uint8_t biological, uint8_t tileType) const;
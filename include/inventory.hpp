@@ -52,6 +52,8 @@ public:
     bool tryTakeItem(item& anItem, std::optional<itemType> desiredType);
 
     const std::vector<InventorySlot>& getSlots() const { return slots; }
+    // Overwrite a slot's contents (for machines whose state is kept elsewhere)
+    void setSlotItem(size_t index, item anItem) { slots[index].currentItem = anItem; }
 
 private:
     std::vector<InventorySlot> slots;
@@ -19,13 +19,26 @@ public:
     machine* getMachineAt(globalMachinePos pos);
     void removeMachineAt(globalMachinePos pos);
 
+    // Advance every machine, one loop per type
     void update();
     void render();
 
+    // Per-type machine state (handles read their slot for rendering and UI)
+    const DrillStore& getDrills() const { return drills; }
+    const ConveyorStore& getConveyors() const { return conveyors; }
+
     // Pointer to the world to interact with tiles
     chunkManager* world = nullptr;
 
 private:
     std::vector<std::unique_ptr<machine>> machines;
     std::map<globalMachinePos, machine*, CompareGlobalMachinePos> machineGrid;
+    DrillStore drills;
+    ConveyorStore conveyors;
+    // Store targets are slots, so they are resolved again after machines
+    // are added or removed
+    bool linksDirty = false;
+    void relink();
+    // Drop a machine's store entry and fix up the handle moved into its slot
+    void releaseSlot(machine* m);
 };
\ No newline at end of file
@@ -65,6 +65,13 @@ struct CompareGlobalMachinePos {
     }
 };
 
+/**
+ * machine - Handle for one placed machine
+ *
+ * Holds what placement, rendering and inspection need. Simulation state
+ * lives in machineManager's per-type stores (see ConveyorStore) at index slot,
+ * so the update loops never touch these objects.
+ */
 class machine {
     public:
         machine(machineType type, Vector3 position);
@@ -82,15 +89,15 @@ class machine {
         globalMachinePos globalPos; //for machine interactions
         direction dir = NORTH;
 
-    // Update method now takes the manager to allow for interactions
-    virtual void update(machineManager& manager) = 0;
+        // Set by machineManager::addMachine: the manager and this machine's
+        // index in its type's store (moves when other machines are removed)
+        machineManager* owner = nullptr;
+        uint32_t slot = 0;
+
     virtual void render() = 0;
 
-    // Inventory system access
+    // Inventory system access; machines with a store fill it from there
     virtual Inventory* getInventory() { return nullptr; }
-
-    // Item giving method
-    virtual bool giveItem(item anItem, machineManager& manager) { return false; }
     
     // Get the global position of a slot based on machine direction
     globalMachinePos getSlotGlobalPosition(const machineTileOffset& slotOffset) const;
@@ -110,31 +117,21 @@ class drillMk1 : public machine {
         drillMk1(Vector3 position);
         ~drillMk1();
     
-    void update(machineManager& manager) override;
     void render() override;
-    Inventory* getInventory() override { return &inventory; }
+    Inventory* getInventory() override;
     
     private:
-        float productionProgress = 0.0f;
-        Inventory inventory;
+        Inventory inventory;  // Slot layout; contents copied from the store on inspection
 };
 
 class conveyorMk1 : public machine {
     public:
         conveyorMk1(Vector3 position);
-        void update(machineManager& manager) override;
         void render() override;
 
-        Inventory* getInventory() override { return &inventory; }
-        bool giveItem(item anItem, machineManager& manager) override;
+        Inventory* getInventory() override;
     private:
-        Inventory inventory;
-        item heldItem;
-        bool hasHeldItem = false;
-        float processingProgress = 0.0f;
-        const float PROCESSING_TIME = 0.5f; // 0.5 seconds processing time
-        float movementProgress = 0.0f; // For lerping item position
-        bool hasItemToRender = false; // Track if we should render an item
+        Inventory inventory;  // Slot layout; contents copied from the store on inspection
 };
 
 class droppedItem : public machine {
@@ -143,7 +140,48 @@ class droppedItem : public machine {
         ~droppedItem();
 
         item itemInstance;
-    void update(machineManager& manager) override;
     void render() override;
     private:
 };
+
+/**
+ * ConveyorStore - Dense state of every conveyor, one entry per slot
+ *
+ * Parallel arrays instead of per-object members, so update() is a plain
+ * loop over contiguous memory with no virtual calls or map lookups. The
+ * conveyor in front of each one is resolved to a slot ahead of time.
+ */
+struct ConveyorStore {
+    static constexpr float PROCESSING_TIME = 0.5f;  // Seconds to carry an item across
+
+    std::vector<machine*> handles;
+    std::vector<float> progress;     // Seconds since the held item arrived
+    std::vector<uint16_t> items;     // Held item type, valid while full
+    std::vector<uint8_t> full;
+    std::vector<int32_t> target;     // Conveyor slot in front, -1 if none
+
+    size_t size() const { return handles.size(); }
+    uint32_t add(machine* handle);
+    // Swap-remove: returns the handle moved into slot, nullptr if none
+    machine* remove(uint32_t slot);
+    // Take an item if the conveyor is empty
+    bool accept(uint32_t slot, uint16_t type);
+    void update(float dt);
+};
+
+// Dense state of every drill, see ConveyorStore
+struct DrillStore {
+    static constexpr float PRODUCTION_TIME = 2.0f;  // Seconds to produce 1 ore
+    static constexpr uint16_t OUTPUT_CAPACITY = 64;
+
+    std::vector<machine*> handles;
+    std::vector<float> progress;
+    std::vector<uint16_t> output;  // Ore kept when nothing in front took it
+    std::vector<int32_t> target;   // Conveyor slot in front, -1 if none
+
+    size_t size() const { return handles.size(); }
+    uint32_t add(machine* handle);
+    machine* remove(uint32_t slot);
+    // Produce ore and hand it to the conveyor in front, if it has room
+    void update(float dt, ConveyorStore& conveyors);
+};
@@ -0,0 +1,108 @@
+#ifndef MESHDATA_HPP
+#define MESHDATA_HPP
+
+#include <cstddef>
+#include <vector>
+#include "terrainMesh.hpp"
+#include "grass.hpp"
+#include "propScatter.hpp"
+
+// Vertex range owned by one tile row of a chunk mesh. Rows are laid out back
+// to back with some slack so an edited row can be re-emitted in place.
+struct MeshRowSpan {
+    int offset = 0;    // First vertex (or index, for indexed meshes) of the row
+    int count = 0;     // Elements currently emitted
+    int capacity = 0;  // Elements reserved (count + slack)
+};
+
+/**
+ * Mesh build stage output
+ *
+ * Plain CPU buffers produced by the tileGrid / GrassField build functions.
+ * Building makes no raylib or GL calls, so it can run off the main thread;
+ * the matching upload functions must run on the GL thread, normally through
+ * MeshUploadQueue. clear() keeps the vectors' capacity, so a pooled chunk
+ * rebuilds into the same allocations.
+ */
+struct TerrainMeshData {
+    std::vector<PackedTerrainVertex> vertices;
+    std::vector<MeshRowSpan> rows;
+    std::vector<PackedTerrainVertex> lods[TERRAIN_LOD_LEVELS - 1];  // Coarse meshes, level 1 first
+
+    void clear() {
+        vertices.clear();
+        rows.clear();
+        for (auto& lod : lods) lod.clear();
+    }
+    size_t byteSize() const {
+        size_t count = vertices.size();
+        for (const auto& lod : lods) count += lod.size();
+        return count * sizeof(PackedTerrainVertex);
+    }
+};
+
+struct WaterMeshData {
+    std::vector<float> vertices;           // xyz, one vertex per tile corner
+    std::vector<float> normals;            // xyz
+    std::vector<float> texcoords;          // Base terrain height, flow angle
+    std::vector<unsigned short> indices;
+    std::vector<MeshRowSpan> rows;         // Index range of each tile row
+
+    void clear() {
+        vertices.clear();
+        normals.clear();
+        texcoords.clear();
+        indices.clear();
+        rows.clear();
+    }
+    bool empty() const { return indices.empty(); }
+    size_t byteSize() const {
+        return (vertices.size() + normals.size() + texcoords.size()) * sizeof(float) +
+               indices.size() * sizeof(unsigned short);
+    }
+};
+
+struct GrassInstanceData {
+    std::vector<PackedGrassInstance> instances;
+    int originX = 0;  // World tile the instance positions are relative to
+    int originZ = 0;
+
+    void clear() { instances.clear(); }
+    size_t bladeCount() const { return instances.size(); }
+    size_t byteSize() const { return instances.size() * sizeof(PackedGrassInstance); }
+};
+
+struct PropInstanceData {
+    std::vector<PackedPropInstance> instances[PROP_TYPE_COUNT];  // One list per PropType
+    int originX = 0;  // World tile the instance positions are relative to
+    int originZ = 0;
+    float top = -1e30f;  // Highest point of any prop
+
+    void clear() {
+        for (auto& list : instances) list.clear();
+        top = -1e30f;
+    }
+    size_t count() const {
+        size_t total = 0;
+        for (const auto& list : instances) total += list.size();
+        return total;
+    }
+    size_t byteSize() const { return count() * sizeof(PackedPropInstance); }
+};
+
+// Everything a freshly generated chunk needs to upload. Grass is built
+// separately, on demand (see chunkManager::updateGrass).
+struct ChunkMeshData {
+    TerrainMeshData terrain;
+    WaterMeshData water;
+    PropInstanceData props;
+
+    void clear() {
+        terrain.clear();
+        water.clear();
+        props.clear();
+    }
+    size_t byteSize() const { return terrain.byteSize() + water.byteSize() + props.byteSize(); }
+};
+
+#endif // MESHDATA_HPP
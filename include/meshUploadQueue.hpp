@@ -0,0 +1,52 @@
+#ifndef MESHUPLOADQUEUE_HPP
+#define MESHUPLOADQUEUE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * MeshUploadQueue - Main-thread queue of pending GPU uploads
+ *
+ * Mesh data is built on the CPU and queued here together with its size.
+ * drain() runs uploads in FIFO order until the per-frame time or byte budget
+ * is spent; at least one upload runs per drain so a single large mesh cannot
+ * stall the queue. push(), cancel() and the getters are thread-safe, drain()
+ * must be called from the GL thread.
+ */
+class MeshUploadQueue {
+public:
+    struct Budget {
+        double maxMs = 2.0;                  // Upload time per frame
+        size_t maxBytes = 4 * 1024 * 1024;   // Upload volume per frame
+    };
+
+    // Queue an upload; owner identifies the jobs to drop in cancel()
+    void push(const void* owner, size_t bytes, std::function<void()> upload);
+    // Drop all pending uploads of owner (e.g. a chunk being unloaded)
+    void cancel(const void* owner);
+    void clear();
+
+    // Run queued uploads until the budget is exhausted
+    void drain();
+
+    void setBudget(const Budget& newBudget);
+    Budget getBudget() const;
+    size_t getPendingCount() const;
+    size_t getPendingBytes() const;
+
+private:
+    struct Job {
+        const void* owner;
+        size_t bytes;
+        std::function<void()> upload;
+    };
+
+    mutable std::mutex mutex;
+    std::deque<Job> jobs;
+    size_t pendingBytes = 0;
+    Budget budget;
+};
+
+#endif // MESHUPLOADQUEUE_HPP
@@ -0,0 +1,96 @@
+#ifndef PROFILING_HPP
+#define PROFILING_HPP
+
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * ProfileTimer - Rolling statistics for one named timer (milliseconds)
+ */
+struct ProfileTimer {
+    double lastMs = 0.0;
+    double avgMs = 0.0;     // Exponential moving average
+    double maxMs = 0.0;
+    uint64_t calls = 0;
+};
+
+/**
+ * Profiler - Lightweight in-game timers and counters
+ *
+ * Timers, counters and free-form values are keyed by name and listed in
+ * an ImGui window. Recording is thread-safe so worker threads can report
+ * too. Instrumentation is compiled in only when TILEGRID_PROFILE is
+ * defined (see CMakeLists.txt); otherwise the PROFILE_* macros vanish.
+ */
+class Profiler {
+public:
+    static Profiler& getInstance();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void recordTime(const char* name, double ms);
+    void addCount(const char* name, int64_t delta);
+    void setCount(const char* name, int64_t value);
+    void setValue(const char* name, double value);
+
+    int64_t getCount(const char* name) const;
+    double getValue(const char* name) const;
+    ProfileTimer getTimer(const char* name) const;
+
+    // Clear all timers, counters and values
+    void reset();
+
+    // Draw the profiler window (call between rlImGuiBegin/rlImGuiEnd)
+    void renderUI(bool* open = nullptr);
+
+private:
+    Profiler() = default;
+    ~Profiler() = default;
+
+    // Transparent comparison: recording under a known name allocates nothing
+    mutable std::mutex mutex;
+    std::map<std::string, ProfileTimer, std::less<>> timers;
+    std::map<std::string, int64_t, std::less<>> counters;
+    std::map<std::string, double, std::less<>> values;
+};
+
+/**
+ * ScopedTimer - Records the lifetime of the enclosing scope into a named timer
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name)
+        : name(name), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        Profiler::getInstance().recordTime(name, elapsed.count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef TILEGRID_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_COUNT(name, delta) Profiler::getInstance().addCount(name, delta)
+#define PROFILE_SET(name, value) Profiler::getInstance().setCount(name, value)
+#define PROFILE_VALUE(name, value) Profiler::getInstance().setValue(name, value)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(name, delta) ((void)0)
+#define PROFILE_SET(name, value) ((void)0)
+#define PROFILE_VALUE(name, value) ((void)0)
+#endif
+
+#endif // PROFILING_HPP
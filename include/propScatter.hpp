@@ -0,0 +1,143 @@
+#ifndef PROPSCATTER_HPP
+#define PROPSCATTER_HPP
+
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class tileGrid;
+struct PropInstanceData;
+
+// Kinds of scattered prop. Every kind has one shared mesh (PropMeshes) and
+// one instance buffer per chunk (PropField).
+enum class PropType : uint8_t {
+    ROCK = 0,
+    SHRUB,
+    TREE,
+    CRYSTAL,
+    COUNT
+};
+
+inline constexpr int PROP_TYPE_COUNT = static_cast<int>(PropType::COUNT);
+
+/**
+ * PackedPropInstance - 12-byte per-prop instance record
+ *
+ * Position uses the fixed point encoding of PackedGrassInstance (chunk-local
+ * x/z in 1/POSITION_SCALE tiles, y in 1/HEIGHT_UNITS units biased by
+ * HEIGHT_BIAS), placed by the chunkOrigin uniform. propShader.vs decodes
+ * this layout.
+ */
+struct PackedPropInstance {
+    uint16_t position[3];  // x, y (biased), z
+    uint16_t color;        // RGB565 tint
+    uint8_t scale;         // 0..255 -> 0..MAX_SCALE
+    uint8_t yaw;           // 0..255 -> 0..2pi
+    uint8_t stretch;       // Vertical scale on top of scale, 0..MAX_STRETCH
+    uint8_t reserved;
+
+    static constexpr float POSITION_SCALE = 1024.0f;
+    static constexpr float HEIGHT_UNITS = 64.0f;
+    static constexpr int HEIGHT_BIAS = 32768;
+    static constexpr float MAX_SCALE = 4.0f;
+    static constexpr float MAX_STRETCH = 2.0f;
+
+    static PackedPropInstance pack(float localX, float y, float localZ, float scale,
+                                   float yaw, float stretch, Vector3 color);
+};
+
+static_assert(sizeof(PackedPropInstance) == 12, "PackedPropInstance must stay 12 bytes");
+
+/**
+ * PropMeshes - Shared low-poly meshes of the prop types
+ *
+ * Built procedurally on first use (flat-shaded triangle lists, no assets).
+ * Every PropField binds these vertex buffers into its own VAOs next to its
+ * instance buffers.
+ *
+ * Main thread only. Never destroyed: its buffers go away with the GL context.
+ */
+class PropMeshes {
+public:
+    struct Buffers {
+        unsigned int positions = 0;  // vec3
+        unsigned int normals = 0;    // vec3
+        unsigned int tints = 0;      // float: 1 = instance colour, 0 = trunk colour
+        int vertexCount = 0;
+    };
+
+    static PropMeshes& getInstance();
+    const Buffers& get(PropType type);
+
+private:
+    PropMeshes() = default;
+    Buffers buffers[PROP_TYPE_COUNT];
+};
+
+/**
+ * PropField - Scattered rocks, shrubs, trees and crystals of a chunk
+ *
+ * build() places props without touching the GPU (safe on a worker, it only
+ * reads the chunk's own tiles); upload() fills one instance buffer per prop
+ * type. Placement is a Poisson-disk set over world space (one jittered
+ * candidate per grid cell, kept if no candidate within the type's spacing
+ * has a higher priority), thinned by BiomeData::scatter and the tile
+ * potentials. Candidates only depend on world hashes, so the pattern is
+ * seamless across chunk borders.
+ *
+ * Instances are stored in random order, so drawing a prefix is an even
+ * subsample: chunkManager::renderProps draws each type of a chunk with one
+ * instanced call, thinned with distance.
+ */
+class PropField {
+public:
+    PropField() = default;
+    ~PropField();
+
+    PropField(const PropField&) = delete;
+    PropField& operator=(const PropField&) = delete;
+
+    // Build stage: fill per-instance data from the chunk's tiles
+    static void build(PropInstanceData& out, tileGrid& tiles, int originX, int originZ);
+    // Upload stage: replace the instance data with built data (main thread)
+    void upload(const PropInstanceData& data);
+
+    // Draw nothing, but keep the buffers for the next upload
+    void resetInstances();
+    // Release the instance buffers
+    void clear();
+
+    // Draw the first density fraction of one type's instances. The prop
+    // shader must be enabled with its shared uniforms set; returns false if
+    // nothing was drawn.
+    bool draw(PropType type, float density) const;
+
+    size_t getInstanceCount(PropType type) const { return layers[static_cast<int>(type)].count; }
+    size_t getInstanceCount() const;
+    // Highest point of any prop, for the chunk bounds (-inf if none)
+    float getTop() const { return top; }
+    size_t getGpuBytes() const;
+
+    // Distance LOD: all instances up to getLodStart(), none beyond getMaxDistance()
+    static float getLodStart(PropType type);
+    static float getMaxDistance(PropType type);
+    static float lodDensity(PropType type, float distance);
+
+private:
+    struct Layer {
+        unsigned int vaoId = 0;
+        unsigned int vboInstances = 0;
+        size_t count = 0;
+        size_t capacity = 0;  // Instances the buffer can hold
+    };
+
+    Layer layers[PROP_TYPE_COUNT];
+    float originX = 0.0f;
+    float originZ = 0.0f;
+    float top = -1e30f;
+
+    void uploadLayer(PropType type, const std::vector<PackedPropInstance>& instances);
+};
+
+#endif // PROPSCATTER_HPP
@@ -49,6 +49,8 @@ struct TerrainShaderLocs {
     int stoneExposedU;
     // Visualization mode
     int visualizationMode;
+    // 1 while drawing packed terrain vertices, 0 for float meshes (machines)
+    int packedVertices;
 };
 
 struct WaterShaderLocs {
@@ -66,6 +68,20 @@ struct GrassShaderLocs {
     int mvp;
     int viewPos;
     int time;
+    int chunkOrigin;
+    int bladeCount;
+    // Distance thinning and fade (see grassShader.vs)
+    int lodSpacing;
+    int lodReduction;
+    int lodMaxLevel;
+    int fadeStart;
+    int fadeEnd;
+    // Blade height and dirt blend, applied per instance (see PackedGrassInstance)
+    int baseHeightScale;
+    int heightVariation;
+    int dirtBlendColor;
+    int dirtBlendDistance;
+    int dirtBlendStrength;
     int windStrength;
     int windDirection;
     int windSpeed;
@@ -97,6 +113,21 @@ struct GrassShaderLocs {
     int desertFullTemp;
 };
 
+struct PropShaderLocs {
+    int mvp;
+    int viewPos;
+    int chunkOrigin;
+    int instanceCount;
+    // Distance thinning (see propShader.vs), set per prop type
+    int lodStart;
+    int lodEnd;
+    int trunkColor;
+    int sunDirection;
+    int sunColor;
+    int ambientStrength;
+    int ambientColor;
+};
+
 class resourceManager {
 public:
     // Initialize and load all machine assets
@@ -133,10 +164,17 @@ public:
                                     float ambientStrength, Vector3 ambientColor,
                                     float shiftIntensity, float shiftDisplacement);
     
+    // Update prop shader uniforms
+    static void updatePropUniforms(Vector3 cameraPos, Vector3 sunDirection, Vector3 sunColor,
+                                   float ambientStrength, Vector3 ambientColor);
+    
     // Get grass shader and material
     static Shader& getGrassShader();
     static Material& getGrassMaterial();
     static GrassShaderLocs& getGrassShaderLocs();
+    static Shader& getPropShader();
+    static PropShaderLocs& getPropShaderLocs();
+    static TerrainShaderLocs& getTerrainShaderLocs();
     
     // Apply all settings from VisualSettings singleton
     static void applyVisualSettings();
@@ -165,9 +203,11 @@ private:
     static Shader waterShader;
     static Shader grassShader;
     static Material grassMaterial;
+    static Shader propShader;
     
     // Cached uniform locations
     static TerrainShaderLocs terrainLocs;
     static WaterShaderLocs waterLocs;
     static GrassShaderLocs grassLocs;
+    static PropShaderLocs propLocs;
 };
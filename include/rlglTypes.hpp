@@ -0,0 +1,18 @@
+#ifndef RLGLTYPES_HPP
+#define RLGLTYPES_HPP
+
+#include "rlgl.h"
+
+// rlgl only names the float and unsigned byte GL types; the packed vertex
+// and instance layouts also need these for rlSetVertexAttribute
+#ifndef RL_BYTE
+#define RL_BYTE 0x1400
+#endif
+#ifndef RL_SHORT
+#define RL_SHORT 0x1402
+#endif
+#ifndef RL_UNSIGNED_SHORT
+#define RL_UNSIGNED_SHORT 0x1403
+#endif
+
+#endif // RLGLTYPES_HPP
@@ -0,0 +1,97 @@
+#ifndef SCRATCHARENA_HPP
+#define SCRATCHARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/**
+ * ScratchArena - Per-thread bump allocator for transient build buffers
+ *
+ * Terrain generation and meshing fill many short-lived grids and vertex
+ * lists. They are std::pmr containers on the calling thread's arena, opened
+ * with a ScratchScope; deallocation is a no-op and everything allocated in
+ * a scope is dropped when it ends. If a build overflows the arena, the extra
+ * blocks are folded into one larger block once the outermost scope ends, so
+ * after the first few chunks every build fits and scratch stops touching
+ * the global heap.
+ *
+ * Every thread has its own arena (workers and the main thread alike);
+ * nothing is shared or locked. Memory from a scope must not outlive it.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Global heap allocations made by threads inside a ScratchScope (only
+    // counted with TILEGRID_PROFILE, which replaces the global operator new)
+    static int64_t getScopedHeapAllocations();
+    // Bytes held by all threads' arenas
+    static int64_t getReservedBytes();
+
+private:
+    friend class ScratchScope;
+
+    struct Block {
+        Block* prev;   // Older block, nullptr for the base block
+        size_t size;   // Usable bytes after the header
+    };
+    struct Mark {
+        Block* block;
+        size_t offset;
+        size_t used;
+    };
+
+    static constexpr size_t INITIAL_BYTES = 256 * 1024;
+
+    ScratchArena();
+    ~ScratchArena() override;
+
+    static ScratchArena& forThread();
+
+    Mark mark() const { return {head, offset, used}; }
+    // Drop everything allocated since m; at depth 0 also grow the base
+    // block to the high-water mark if the scope overflowed it
+    void rewind(const Mark& m);
+
+    Block* allocateBlock(size_t size, Block* prev);
+    void freeBlock(Block* block);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    Block* base = nullptr;
+    Block* head = nullptr;  // Block allocations come from
+    size_t offset = 0;      // Bytes used in head
+    size_t used = 0;        // Bytes used over all blocks (for the high-water mark)
+    size_t highWater = 0;
+    int depth = 0;          // Open scopes
+};
+
+/**
+ * ScratchScope - RAII window onto the calling thread's ScratchArena
+ *
+ * Scopes nest like stack frames; each drops its own allocations when it
+ * ends. Pass resource() to std::pmr containers:
+ *
+ *     ScratchScope scratch;
+ *     std::pmr::vector<float> heights(n, scratch.resource());
+ */
+class ScratchScope {
+public:
+    ScratchScope();
+    ~ScratchScope();
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+private:
+    ScratchArena& arena;
+    ScratchArena::Mark start;
+};
+
+#endif // SCRATCHARENA_HPP
@@ -0,0 +1,116 @@
+#ifndef TERRAINARENA_HPP
+#define TERRAINARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct PackedTerrainVertex;
+
+// Terrain detail levels. Level 0 is the full tile mesh; level n merges
+// (1 << n) x (1 << n) tiles into one cell and hangs skirts off the chunk
+// border to hide cracks against neighbours drawn at another level.
+inline constexpr int TERRAIN_LOD_LEVELS = 3;
+
+/**
+ * TerrainArena - One shared vertex buffer carved into terrain blocks
+ *
+ * Blocks are first-fit suballocations of a single VBO. Everything outside
+ * the written part of a live block is kept zeroed, i.e. degenerate
+ * triangles, so a run of marked blocks can be drawn with one call even
+ * across free space between them.
+ */
+class TerrainArena {
+public:
+    struct Block {
+        int offset = 0;
+        int capacity = 0;
+        uint32_t drawFrame = 0;  // Frame the block was last marked for drawing
+    };
+
+    explicit TerrainArena(int capacity);
+    ~TerrainArena();
+
+    TerrainArena(const TerrainArena&) = delete;
+    TerrainArena& operator=(const TerrainArena&) = delete;
+
+    // Reserve count vertices, rounded up to whole triangles; nullptr if no
+    // free range is large enough
+    Block* allocate(int count);
+    // Return a block, zeroing the written vertices at its start
+    void release(Block* block, int written);
+
+    // Copy vertices to [first, first + count), moved by (offsetX, offsetZ)
+    // quarter units from chunk-local to region-local positions
+    void write(int first, const PackedTerrainVertex* vertices, int count, int16_t offsetX, int16_t offsetZ);
+    void zero(int first, int count);
+
+    // Draw the blocks marked with frame; returns the number of draw calls
+    int drawMarked(uint32_t frame) const;
+
+    bool empty() const { return blocks.empty(); }
+    int getCapacity() const { return capacity; }
+
+private:
+    unsigned int vaoId = 0;
+    unsigned int vboId = 0;
+    int capacity;
+    std::map<int, Block> blocks;   // Live blocks by offset
+    std::map<int, int> freeRanges; // Offset -> size, coalesced
+};
+
+/**
+ * TerrainArenas - Terrain vertex storage grouped by region
+ *
+ * The world is split into REGION_SIZE x REGION_SIZE tile regions (4 x 4
+ * chunks). Every chunk mesh lives in an arena of its region and detail level,
+ * with vertices stored relative to the region origin, so draw() sets up the
+ * terrain shader once per pass and issues one draw per run of visible blocks:
+ * O(arenas) per region rather than O(chunks). Arenas of emptied regions are
+ * kept for reuse, so streaming does not create GL objects.
+ *
+ * Main thread only. Never destroyed: its buffers go away with the GL context.
+ */
+class TerrainArenas {
+public:
+    static constexpr int REGION_SIZE = 128;
+
+    static TerrainArenas& getInstance();
+
+    struct Region;
+    struct Allocation {
+        Region* region = nullptr;
+        TerrainArena* arena = nullptr;
+        TerrainArena::Block* block = nullptr;
+    };
+    Allocation allocate(int regionX, int regionY, int level, int count);
+    void release(Allocation& allocation, int written);
+    // Mark an allocation for the next draw(frame)
+    void mark(const Allocation& allocation, uint32_t frame);
+    // Draw every block marked with frame; returns the number of draw calls
+    int draw(uint32_t frame);
+
+    size_t getArenaCount() const;
+    size_t getRegionCount() const { return regions.size(); }
+    size_t getGpuBytes() const;
+
+    struct Region {
+        int x = 0;
+        int y = 0;
+        std::vector<std::unique_ptr<TerrainArena>> arenas[TERRAIN_LOD_LEVELS];
+        int blocks = 0;
+        uint32_t drawFrame = 0;
+    };
+
+private:
+    TerrainArenas() = default;
+
+    std::unordered_map<uint64_t, Region> regions;
+    // Emptied arenas, ready for another region
+    std::vector<std::unique_ptr<TerrainArena>> spare[TERRAIN_LOD_LEVELS];
+};
+
+#endif // TERRAINARENA_HPP
@@ -0,0 +1,87 @@
+#ifndef TERRAINMESH_HPP
+#define TERRAINMESH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <raylib.h>
+#include "terrainArena.hpp"
+
+/**
+ * PackedTerrainVertex - 16-byte terrain vertex (vs. 36 bytes for raylib's
+ * float position/UV/normal + RGBA8 layout)
+ *
+ * Tile corners sit on integer x/z and heights on quarter units, so positions
+ * are stored as int16 in quarter units. The normal is octahedral-encoded into
+ * two snorm8 values, and UVs are replaced by the texture atlas cell plus
+ * which corner of the cell the vertex uses. terrainShader.vs decodes this
+ * layout when the packedVertices uniform is set.
+ */
+struct PackedTerrainVertex {
+    int16_t position[4];   // x, y, z in 1/POSITION_SCALE units; w is padding
+    int8_t normal[2];      // Octahedral-encoded unit normal (snorm8)
+    uint8_t atlasCell;     // Atlas cell index (row-major, ATLAS_COLUMNS wide)
+    uint8_t corner;        // bit 0 = u max, bit 1 = v max
+    uint8_t color[4];      // Tile data: primary tex, secondary tex, blend, erosion
+
+    static constexpr float POSITION_SCALE = 4.0f;
+
+    static PackedTerrainVertex pack(Vector3 position, Vector3 normal,
+                                    uint8_t atlasCell, uint8_t corner, Color color);
+};
+
+static_assert(sizeof(PackedTerrainVertex) == 16, "PackedTerrainVertex must stay 16 bytes");
+
+// Per-vertex size of the float layout this replaces (for memory comparisons)
+inline constexpr size_t FLOAT_TERRAIN_VERTEX_BYTES = 3 * sizeof(float) + 2 * sizeof(float) + 3 * sizeof(float) + 4;
+
+/**
+ * TerrainMesh - One chunk mesh of packed terrain vertices
+ *
+ * The vertices live in a block of a shared TerrainArena of the chunk's
+ * region and detail level (see TerrainArenas); the mesh itself owns no GL
+ * objects and is drawn by marking it for the next TerrainArenas::draw().
+ *
+ * Blocks outlive their contents: upload() rewrites the block in place
+ * whenever the new vertices fit (blocks are allocated with some headroom),
+ * so edits and pooled chunks refill terrain without reallocating.
+ */
+class TerrainMesh {
+public:
+    TerrainMesh() = default;
+    ~TerrainMesh();
+
+    TerrainMesh(const TerrainMesh&) = delete;
+    TerrainMesh& operator=(const TerrainMesh&) = delete;
+
+    // Arena the mesh is stored in: region, detail level, and where the
+    // chunk origin sits in the region (tiles). Releases the block if it moves.
+    void setPlacement(int regionX, int regionY, int level, int originX, int originZ);
+
+    // Replace the contents, reusing the block when they fit
+    void upload(const PackedTerrainVertex* vertices, int count);
+    // Overwrite vertices [first, first + count) in place
+    void update(int first, const PackedTerrainVertex* vertices, int count);
+    // Draw nothing and give the block back to the arena
+    void clear();
+
+    // Include the mesh in the next TerrainArenas::draw(frame)
+    void mark(uint32_t frame) const;
+
+    bool isLoaded() const { return allocation.block != nullptr && vertexCount > 0; }
+    int getVertexCount() const { return vertexCount; }
+    size_t getGpuBytes() const {
+        return allocation.block ? (size_t)allocation.block->capacity * sizeof(PackedTerrainVertex) : 0;
+    }
+
+private:
+    TerrainArenas::Allocation allocation;
+    int vertexCount = 0;
+    int written = 0;  // Vertices of the block holding data (the rest is zero)
+    int regionX = 0;
+    int regionY = 0;
+    int level = 0;
+    int16_t offsetX = 0;  // Chunk origin in the region, quarter units
+    int16_t offsetZ = 0;
+};
+
+#endif // TERRAINMESH_HPP
@@ -1,6 +1,17 @@
 #ifndef TEXTURE_ATLAS_HPP
 #define TEXTURE_ATLAS_HPP
 
+#include <cstdint>
+
+// Atlas layout: textures.png is 80x16, one 16x16 cell per texture
+inline constexpr int ATLAS_CELL_SIZE = 16;
+inline constexpr int ATLAS_COLUMNS = 5;
+
+// Row-major cell index of the atlas cell at pixel offset (u, v)
+inline uint8_t atlasCellIndex(int u, int v) {
+    return static_cast<uint8_t>((v / ATLAS_CELL_SIZE) * ATLAS_COLUMNS + u / ATLAS_CELL_SIZE);
+}
+
 struct textureAtlas {
     int width;
     int height;
@@ -2,11 +2,18 @@
 #define TILEGRID_HPP
 
 #include <vector>
+#include <atomic>
+#include <memory_resource>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
 #include <raylib.h>
 #include <cstdint> // for uint64_t
 
 #include "resourceManager.hpp"
 #include "biome.hpp"
+#include "terrainMesh.hpp"
+#include "meshData.hpp"
 
 
 // Tunable parameters for water and hydrology generation
@@ -24,6 +31,88 @@ struct WaterParams {
 
 class machine;
 
+// D8 slots of tileGrid::neighborChunks (same order as tile::flowDir)
+enum NeighborDir { DIR_E = 0, DIR_SE, DIR_S, DIR_SW, DIR_W, DIR_NW, DIR_N, DIR_NE };
+
+// Chunk edges whose wall strips a tileGrid owns; the west and north edges
+// belong to the neighbouring chunks' east and south seams
+enum SeamEdge { SEAM_EAST = 0, SEAM_SOUTH, SEAM_COUNT };
+
+// Half-open rectangle of tiles [x0, x1) x [y0, y1) in chunk-local coordinates
+struct TileRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+};
+
+// Min/max surface height over a group of tiles, used to prune ray picks
+struct HeightBounds {
+    float minH = FLT_MAX;
+    float maxH = -FLT_MAX;
+    void include(float h) { minH = std::min(minH, h); maxH = std::max(maxH, h); }
+    // Does the ray's height over [t0, t1] overlap these bounds?
+    bool overlaps(const Ray& ray, float t0, float t1) const {
+        float y0 = ray.position.y + ray.direction.y * t0;
+        float y1 = ray.position.y + ray.direction.y * t1;
+        return std::min(y0, y1) <= maxH && std::max(y0, y1) >= minH;
+    }
+};
+
+// Result of a terrain ray pick
+struct TileHit {
+    int x = -1, y = -1;        // Tile hit (chunk-local from tileGrid, global from chunkManager)
+    float distance = 0.0f;     // Ray parameter at the hit
+    Vector3 point = {0, 0, 0}; // Hit position in the same space as the tile coordinates
+};
+
+// 2D grid traversal (Amanatides & Woo) of a ray over square cells on the XZ plane.
+// Visits cells in ray order; t is the ray parameter where the current cell is entered.
+struct GridWalker {
+    int cx, cy;
+    int stepX, stepY;
+    float t;
+    float tMaxX, tMaxY;     // Ray parameter of the next x / z cell boundary
+    float tDeltaX, tDeltaY; // Ray parameter between boundaries
+
+    GridWalker(const Ray& ray, float cellSize, float tStart) : t(tStart) {
+        // Nudge the sample point forward so a start on a boundary lands in the entered cell
+        float px = ray.position.x + ray.direction.x * (tStart + 1e-4f);
+        float pz = ray.position.z + ray.direction.z * (tStart + 1e-4f);
+        cx = (int)std::floor(px / cellSize);
+        cy = (int)std::floor(pz / cellSize);
+        stepX = ray.direction.x >= 0.0f ? 1 : -1;
+        stepY = ray.direction.z >= 0.0f ? 1 : -1;
+        if (ray.direction.x != 0.0f) {
+            float boundary = (cx + (stepX > 0 ? 1 : 0)) * cellSize;
+            tMaxX = (boundary - ray.position.x) / ray.direction.x;
+            tDeltaX = cellSize / std::fabs(ray.direction.x);
+        } else {
+            tMaxX = tDeltaX = FLT_MAX;
+        }
+        if (ray.direction.z != 0.0f) {
+            float boundary = (cy + (stepY > 0 ? 1 : 0)) * cellSize;
+            tMaxY = (boundary - ray.position.z) / ray.direction.z;
+            tDeltaY = cellSize / std::fabs(ray.direction.z);
+        } else {
+            tMaxY = tDeltaY = FLT_MAX;
+        }
+    }
+
+    // Ray parameter where the current cell is left
+    float exitT() const { return std::min(tMaxX, tMaxY); }
+
+    void step() {
+        if (tMaxX < tMaxY) {
+            t = tMaxX;
+            cx += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            t = tMaxY;
+            cy += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+};
+
 struct tile{
     // Biome data
     BiomeType biome;              // Primary biome
@@ -72,6 +161,10 @@ class tileGrid {
     public:
         tileGrid(int width, int height);
         ~tileGrid();
+        // Return to the freshly constructed state for reuse by another chunk.
+        // Tile storage, CPU mesh data and GPU buffers are kept and refilled by
+        // the next build/upload instead of being reallocated.
+        void reset();
         void setTile(int x, int y, tile voxel);
         // Generate terrain with Perlin noise fractal (multiple octaves)
         void generatePerlinTerrain(float scale, int heightCo,
@@ -81,21 +174,88 @@ class tileGrid {
         void renderWires();
         void renderDataPoint(Color a, Color b, uint8_t tile::*dataMember, int chunkX, int chunkY);
 
+        // Build and upload immediately (main thread)
         void generateMesh();
         // Generate a simple water mesh comprised of flat quads at water level per tile
         void generateWaterMesh();
+
+        // Build stage: fill mesh data on the CPU only (no GL calls, safe off the
+        // main thread while nothing else touches this grid)
+        void buildMeshData(TerrainMeshData& out);
+        void buildWaterMeshData(WaterMeshData& out);
+        // Upload stage: create the GPU buffers from built data (main thread)
+        void uploadMesh(TerrainMeshData&& data);
+        void uploadWaterMesh(WaterMeshData&& data);
+
+        // Incremental remeshing: setTile() records edits in a dirty rectangle,
+        // updateDirtyMesh() re-emits only the affected rows and patches the GPU
+        // buffers in place (full rebuild only if a row outgrows its slack)
+        void markDirty(int x0, int y0, int x1, int y1);
+        // Also true after placing or removing a machine, which changes no
+        // mesh but clears or restores the props on its tiles
+        bool hasDirtyTiles() const {
+            return !dirtyRect.empty() || seamDirty[SEAM_EAST] || seamDirty[SEAM_SOUTH] || waterEdgeDirty ||
+                   propsDirty;
+        }
+        void updateDirtyMesh();
+        // True once after an edit touched data that grass placement reads
+        bool consumeGrassDirty();
+        // True once after an edit touched data that prop placement reads
+        bool consumePropsDirty();
         void updateLighting(Vector3 sunDirection, Vector3 sunColor, float ambientStrength, Vector3 ambientColor, float shiftIntensity, float shiftDisplacement);
 
-        Mesh mesh;
+        TerrainMesh terrainMesh;
         Mesh waterMesh;
+        // False for chunks without water; their water model (if any, left over
+        // from a previous use of this grid) is kept for reuse but not drawn
+        bool hasWater() const { return waterModelLoaded && !waterData.empty(); }
+        // Highest water surface in the chunk (for culling bounds)
+        float getWaterTop() const { return waterTop; }
 
+        // Loaded neighbours in D8 order (nullptr when not loaded). Linking an
+        // east or south neighbour schedules a rebuild of that seam only; any
+        // link refreshes the water corners along the shared border.
         tileGrid* neighborChunks[8];
+        void setNeighbor(int dir, tileGrid* neighbor);
+        // Tile at (x, y) in this chunk's local space, reaching up to one chunk
+        // into the neighbours; nullptr when that neighbour is not loaded
+        const tile* borderTile(int x, int y) const;
+        // Wall strip along a shared chunk edge, in this chunk's local space
+        bool hasSeam(int seam) const { return seamMeshes[seam].isLoaded(); }
+        TerrainMesh seamMeshes[SEAM_COUNT];
+        // Coarse terrain for distant chunks, level 1 first (no seams: their
+        // border skirts cover the gaps)
+        TerrainMesh lodMeshes[TERRAIN_LOD_LEVELS - 1];
+        // Mark the terrain at a detail level for the next TerrainArenas::draw();
+        // falls back to the full mesh while the level is not uploaded
+        void markTerrain(int lod, uint32_t frame) const;
+        // Place the terrain meshes in the arenas of the region holding the
+        // chunk origin (world tiles); call before uploading
+        void setPlacement(int originX, int originZ);
+        // Vertices markTerrain() submits at a detail level
+        int getLodVertexCount(int lod) const;
+
+        // Terrain GPU footprint (main mesh, seams and LOD meshes)
+        size_t getTerrainGpuBytes() const;
+        size_t getTerrainVertexCount() const;
+        // Average milliseconds to emit and pack all terrain rows (no upload),
+        // with or without the normal table
+        double benchmarkPacking(int iterations, bool normalTable);
+        // Read top-face normals from the quantized-gradient table instead of
+        // normalizing a cross product per triangle (debug toggle). Workers
+        // mesh concurrently, so each build loads it once and passes it on.
+        static std::atomic<bool> useNormalTable;
         
         unsigned int getWidth();
         unsigned int getHeight();
         unsigned int getDepth();
 
         Vector3 getTileIndexDDA(Ray ray);
+        // Pick the first surface or wall hit along a chunk-local ray within
+        // [tMin, tMax]. Walks 8x8 blocks then tiles, skipping any block whose
+        // height bounds the ray segment cannot touch.
+        bool raycast(const Ray& ray, float tMin, float tMax, TileHit& hit);
+        const HeightBounds& getHeightBounds() const { return chunkBounds; }
 
         // Machine management
         bool placeMachine(int x, int y, machine* machinePtr);
@@ -103,7 +263,6 @@ class tileGrid {
         machine* getMachineAt(int x, int y);
         bool isOccupied(int x, int y);
 
-        Model model;
         Model waterModel;
 
     // Parameters you can tweak at runtime before generation
@@ -113,6 +272,71 @@ class tileGrid {
     void setWaterParams(const WaterParams& params) { waterParams = params; }
 
     private:
+        // CPU-side vertex streams for one mesh row
+        // Emitted vertices; builds keep these on a ScratchArena
+        struct TerrainVertices {
+            std::pmr::vector<PackedTerrainVertex> vertices;
+            bool normalTable = true;  // useNormalTable as loaded for this build
+            TerrainVertices() = default;
+            explicit TerrainVertices(std::pmr::memory_resource* resource) : vertices(resource) {}
+            void clear();
+            void push(Vector3 position, Vector3 normal, uint8_t atlasCell, uint8_t corner, Color color);
+        };
+        // Per-tile water data, padded by one tile on every side with the
+        // neighbouring chunks' border tiles
+        struct WaterCell {
+            float surface = -1000.0f;  // Water surface Y, -1000 when dry
+            float ground = 0.0f;       // Average terrain height (for depth)
+            uint8_t flowDir = 255;     // D8 flow direction, >= 8 when none
+        };
+
+        void emitTerrainTile(int x, int y, TerrainVertices& out);
+        void emitWall(int edge, const tile& t, const tile& n, int x, int y, TerrainVertices& out);
+        void emitTerrainRow(int y, TerrainVertices& out);
+        void writeTerrainRow(const MeshRowSpan& span, const TerrainVertices& row,
+                             std::vector<PackedTerrainVertex>& out);
+        bool patchTerrainRows(int rowBegin, int rowEnd, bool normalTable);
+        // Height of a tile grid point for the coarse meshes (mean of the
+        // corners of the tiles meeting there)
+        float lodCornerHeight(int x, int y) const;
+        void buildLodMesh(int level, std::vector<PackedTerrainVertex>& out, bool normalTable) const;
+        void uploadLodMeshes(const TerrainMeshData& data);
+
+        WaterCell& waterCellAt(int x, int y) { return waterCells[(y + 1) * (width + 2) + (x + 1)]; }
+        void buildWaterCells(int rowBegin, int rowEnd);
+        void writeWaterCorners(WaterMeshData& out, int cornerBegin, int cornerEnd);
+        void emitWaterRow(int y, std::pmr::vector<unsigned short>& out);
+        void writeWaterRow(WaterMeshData& out, const MeshRowSpan& span, const std::pmr::vector<unsigned short>& row);
+        bool patchWaterRows(int rowBegin, int rowEnd);
+        void unloadWaterModel();
+        void updateWaterTop();
+
+        bool raycastTile(const Ray& ray, int x, int y, float tEnter, TileHit& hit);
+        void rebuildHeightBounds(const TileRect& rect);
+        HeightBounds& blockBoundsAt(int x, int y) { return blockBounds[(y / PICK_BLOCK) * blocksX + (x / PICK_BLOCK)]; }
+
+        void markBordersDirty(const TileRect& rect);
+        void generateSeamMesh(int seam);
+
+        std::vector<MeshRowSpan> terrainRows;
+        WaterMeshData waterData;             // CPU copy of the uploaded water mesh, kept for patching
+        std::vector<WaterCell> waterCells;   // (width + 2) x (height + 2)
+        bool waterEdgeDirty = false;         // A neighbour changed along a shared border
+        TileRect dirtyRect;
+        bool grassDirty = false;
+        bool propsDirty = false;
+        bool waterModelLoaded = false;
+        int waterIndexCapacity = 0;          // Indices the water index buffer can hold
+        float waterTop = -FLT_MAX;
+        // Picking acceleration: per-chunk and per-block surface height bounds
+        static constexpr int PICK_BLOCK = 8;
+        int blocksX = 0;
+        int blocksY = 0;
+        HeightBounds chunkBounds;
+        std::vector<HeightBounds> blockBounds;
+
+        bool seamDirty[SEAM_COUNT] = {false, false};
+
         bool meshGenerated = false;
         Image perlinNoise;
         int width;
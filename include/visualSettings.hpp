@@ -3,6 +3,8 @@
 
 #include <raylib.h>
 #include <string>
+#include <algorithm>
+#include <cmath>
 
 // Forward declarations
 struct WorldGenConfig;
@@ -82,6 +84,14 @@ struct GrassSettings {
     float fadeStartDistance = 60.0f;   // Start fading at this distance
     int lodLevels = 3;                 // Number of LOD levels (1-4)
     float lodReduction = 0.5f;         // Density multiplier per LOD level
+
+    // LOD level n covers distances [n, n+1) * lodSpacing() and draws
+    // lodReduction^n of the blades; the last level extends to the end
+    float lodSpacing() const { return renderDistance / std::max(1, lodLevels); }
+    float lodDensity(float distance) const {
+        int level = std::min((int)(distance / std::max(lodSpacing(), 1e-3f)), std::max(1, lodLevels) - 1);
+        return std::pow(std::clamp(lodReduction, 0.0f, 1.0f), (float)std::max(level, 0));
+    }
 };
 
 /**
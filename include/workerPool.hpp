@@ -0,0 +1,60 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool - Fixed set of background threads running prioritized jobs
+ *
+ * Each queued job has an id and a priority; idle workers always take the
+ * queued job with the highest priority. Queued jobs can be cancelled or
+ * re-prioritized by id. A job that has already started runs to completion,
+ * so callers that need to abandon running work must check their own flag.
+ */
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    // threadCount <= 0 picks hardware_concurrency() - 1 (at least one)
+    explicit WorkerPool(int threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(uint64_t id, float priority, Job job);
+    // Remove a queued job; false if it is not queued (running or finished)
+    bool cancel(uint64_t id);
+    // Recompute the priority of every queued job
+    void reprioritize(const std::function<float(uint64_t id)>& priorityOf);
+    // Block until the queue is empty and no job is running
+    void waitIdle();
+
+    int getThreadCount() const { return (int)threads.size(); }
+    size_t getQueuedCount() const;
+    int getActiveCount() const;
+
+private:
+    struct Entry {
+        uint64_t id;
+        float priority;
+        Job job;
+    };
+
+    void workerLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // Work queued or shutdown
+    std::condition_variable idle;      // A job finished
+    std::vector<Entry> queue;          // Small; the best entry is found by linear scan
+    std::vector<std::thread> threads;
+    int active = 0;
+    bool stopping = false;
+};
+
+#endif // WORKERPOOL_HPP
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <mutex>
 #include <memory>
+#include <memory_resource>
 #include <cstdint>
 #include "worldGenerator.hpp"
 
@@ -92,6 +93,13 @@ struct RegionData {
     bool heightsGenerated = false;
     bool potentialsGenerated = false;
     bool waterGenerated = false;
+
+    // Chunks generate on worker threads. terrainMutex guards heights and
+    // erosion, dataMutex potentials and water. Water generation reads the
+    // neighbouring regions' heights while holding dataMutex, so it only ever
+    // takes their terrainMutex and the locks cannot form a cycle.
+    std::mutex terrainMutex;
+    std::mutex dataMutex;
     
     // Get height at local coordinates (with bilinear interpolation)
     float getHeight(float localX, float localZ) const;
@@ -117,7 +125,8 @@ public:
     // Initialize (call after WorldGenerator is initialized)
     void initialize();
     
-    // Clear all cached regions (call when seed changes or config changes)
+    // Clear all cached regions (call when seed changes or config changes).
+    // No chunk may be generating while this runs.
     void clear();
     
     // Get erosion config for tweaking
@@ -129,39 +138,42 @@ public:
     // Get terrain height at world position (will generate/cache as needed)
     float getHeight(float worldX, float worldZ);
     
+    // The grid queries write pmr vectors so callers can keep them on a
+    // ScratchArena (see tileGrid::generatePerlinTerrain)
+    
     // Get heights for a chunk area (more efficient than individual queries)
     // Output is (width+1) x (height+1) corner vertices
     void getHeightGrid(
-        std::vector<float>& out,
+        std::pmr::vector<float>& out,
         int chunkWorldX, int chunkWorldZ,
         int width, int height
     );
     
     // Get potentials for a chunk area
     void getPotentialGrid(
-        std::vector<PotentialData>& out,
+        std::pmr::vector<PotentialData>& out,
         int chunkWorldX, int chunkWorldZ,
         int width, int height
     );
     
     // Get water levels for a chunk area
     void getWaterGrid(
-        std::vector<float>& out,
+        std::pmr::vector<float>& out,
         int chunkWorldX, int chunkWorldZ,
         int width, int height
     );
     
     // Get river data for a chunk area (flowDir, riverWidth, riverCase)
     void getRiverGrid(
-        std::vector<uint8_t>& flowDirOut,
-        std::vector<uint8_t>& riverWidthOut,
+        std::pmr::vector<uint8_t>& flowDirOut,
+        std::pmr::vector<uint8_t>& riverWidthOut,
         int chunkWorldX, int chunkWorldZ,
         int width, int height
     );
     
     // Get erosion intensity for a chunk area
     void getErosionGrid(
-        std::vector<uint8_t>& erosionOut,
+        std::pmr::vector<uint8_t>& erosionOut,
         int chunkWorldX, int chunkWorldZ,
         int width, int height
     );
@@ -171,8 +183,11 @@ public:
     // Get or create a region containing the given world position
     RegionData& getRegion(int worldX, int worldZ);
     
-    // Ensure a region is fully generated (heights + erosion + water)
+    // Ensure a region is fully generated (heights + erosion + water).
+    // Thread-safe; concurrent callers wait for the one generating.
     void ensureRegionReady(RegionData& region);
+    // Ensure heights and erosion only
+    void ensureRegionTerrain(RegionData& region);
     
     // Preload regions around a position (for smooth gameplay)
     void preloadAround(int worldX, int worldZ, int radiusInRegions = 1);
@@ -43,6 +43,9 @@ void BiomeManager::setupBiomeData() {
         b.grass.tipColor = {0.25f, 0.40f, 0.12f};
         b.grass.baseColor = {0.15f, 0.30f, 0.05f};
         
+        // Default props: a few rocks and shrubs
+        b.scatter = {0.05f, 0.1f, 0.0f, 0.0f};
+        
         // Default climate (wide range)
         b.minTemp = 0.0f; b.maxTemp = 1.0f;
         b.minHumidity = 0.0f; b.maxHumidity = 1.0f;
@@ -75,6 +78,7 @@ void BiomeManager::setupBiomeData() {
         b.grass.densityBase = 0.9f;
         b.grass.tipColor = {0.25f, 0.45f, 0.12f};
         b.grass.baseColor = {0.15f, 0.35f, 0.05f};
+        b.scatter = {0.05f, 0.15f, 0.03f, 0.0f}; // Bushes, the odd tree
         
         // Blends to:
         b.blendTargets[0] = BiomeType::BOREAL_FOREST; // Cold edge
@@ -100,6 +104,7 @@ void BiomeManager::setupBiomeData() {
         b.grass.patchScale = 8.0f;
         b.grass.tipColor = {0.70f, 0.60f, 0.40f};
         b.grass.baseColor = {0.50f, 0.40f, 0.25f};
+        b.scatter = {0.15f, 0.05f, 0.0f, 0.0f};  // Rocks, little scrub
         
         // Blends to:
         b.blendTargets[0] = BiomeType::TEMPERATE_GRASSLAND; // Wetter edge
@@ -117,6 +122,7 @@ void BiomeManager::setupBiomeData() {
         b.grass.densityBase = 0.7f;
         b.grass.tipColor = {0.20f, 0.35f, 0.25f};
         b.grass.baseColor = {0.10f, 0.25f, 0.15f};
+        b.scatter = {0.08f, 0.1f, 0.35f, 0.0f};  // Conifer stands
         
         // Blends to:
         b.blendTargets[0] = BiomeType::TUNDRA; // Colder edge
@@ -138,6 +144,7 @@ void BiomeManager::setupBiomeData() {
         b.grass.heightMultiplier = 0.3f;
         b.grass.tipColor = {0.40f, 0.45f, 0.50f};
         b.grass.baseColor = {0.30f, 0.35f, 0.40f};
+        b.scatter = {0.2f, 0.0f, 0.0f, 0.0f};    // Bare boulders
         
         // Blends to:
         b.blendTargets[0] = BiomeType::BOREAL_FOREST; // Warmer edge
@@ -155,15 +162,18 @@ void BiomeManager::setupBiomeData() {
         // Ash-covered grass? Mostly none
         b.grass.enabled = false;
         b.grass.densityBase = 0.0f;
+        b.scatter = {0.5f, 0.0f, 0.0f, 0.0f};    // Basalt fields
     }
     
     // Copy to similar types
     biomes[static_cast<int>(BiomeType::SAVANNA)] = biomes[static_cast<int>(BiomeType::ARID_DESERT)];
     biomes[static_cast<int>(BiomeType::SAVANNA)].name = "Savanna";
     biomes[static_cast<int>(BiomeType::SAVANNA)].grass.densityBase = 0.4f; // More grass than desert
+    biomes[static_cast<int>(BiomeType::SAVANNA)].scatter.treeDensity = 0.05f; // Lone acacias
     
     biomes[static_cast<int>(BiomeType::TEMPERATE_FOREST)] = biomes[static_cast<int>(BiomeType::TEMPERATE_GRASSLAND)];
     biomes[static_cast<int>(BiomeType::TEMPERATE_FOREST)].name = "Temperate Forest";
+    biomes[static_cast<int>(BiomeType::TEMPERATE_FOREST)].scatter.treeDensity = 0.5f;
 }
 
 BiomeType BiomeManager::checkGeologicalOverride(const PotentialData& p) const {
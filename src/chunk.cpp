@@ -1,30 +1,62 @@
 #include "../include/chunk.hpp"
 #include "../include/resourceManager.hpp"
 #include "rlgl.h"
-#include <chrono>
+#include "../include/profiling.hpp"
 
 Chunk::Chunk(int x, int y) : tiles(CHUNKSIZE, CHUNKSIZE) {
-    chunkX = x;
-    chunkY = y;
-    meshGenerated = false;
-    generateMesh();
+    setOrigin(x, y);
 }
 
 Chunk::~Chunk() {
     // tileGrid destructor handles all model/mesh cleanup
-    // Chunk::model is just a copy of the reference, not a separate resource
     // GrassField destructor handles grass cleanup
 }
 
-// Draw opaque terrain
-void Chunk::renderTerrain() {
-    if (!meshGenerated) generateMesh();
-    Vector3 pos = {(float)chunkX, 0.0f, (float)chunkY};
-    DrawModel(model, pos, 1.0f, WHITE);
+void Chunk::setOrigin(int x, int y) {
+    chunkX = x;
+    chunkY = y;
+    tiles.setPlacement(x, y);
+}
+
+void Chunk::reset() {
+    tiles.reset();
+    grass.resetInstances();
+    props.resetInstances();
+    grassLoaded = false;
+    grassRevision++;
+    pendingMesh.clear();
+    meshPending = false;
+    visibleFrame = 0;
+    state = ChunkState::REQUESTED;
+}
+
+BoundingBox Chunk::getBounds() const {
+    const HeightBounds& terrain = tiles.getHeightBounds();
+    float minY = terrain.minH;
+    float maxY = terrain.maxH;
+    // Seam walls hang down to the east and south neighbours' terrain
+    for (int dir : {DIR_E, DIR_S}) {
+        if (tiles.neighborChunks[dir]) minY = std::min(minY, tiles.neighborChunks[dir]->getHeightBounds().minH);
+    }
+    if (tiles.hasWater()) maxY = std::max(maxY, tiles.getWaterTop());
+    if (minY > maxY) minY = maxY = 0.0f;  // Nothing generated yet
+
+    // Water is drawn slightly lowered. Blade height is a visual setting
+    // (up to 2 units plus variation), so leave generous room for grass.
+    const float grassHeight = 3.0f;
+    float topY = std::max(maxY + grassHeight, props.getTop());
+    return BoundingBox{{(float)chunkX, minY - 0.25f, (float)chunkY},
+                       {(float)(chunkX + CHUNKSIZE), topY, (float)(chunkY + CHUNKSIZE)}};
+}
+
+// Queue opaque terrain for the region-batched terrain pass
+void Chunk::markTerrain(int lod, uint32_t frame) {
+    tiles.markTerrain(lod, frame);
 }
 
 // Draw transparent water layer
 void Chunk::renderWater() {
+    if (!tiles.hasWater()) return;
     Vector3 pos = {(float)chunkX, -0.2f, (float)chunkY};
     //rlDisableDepthMask();
     //rlDisableDepthTest();
@@ -34,109 +66,121 @@ void Chunk::renderWater() {
 }
 
 // Draw grass layer
-void Chunk::renderGrass(float time) {
-    grass.render(time);
-}
-
-// Draw terrain wireframe
-void Chunk::renderWires() {
-    if (!meshGenerated) generateMesh();
-    DrawModelWires(model, {(float)chunkX, 0.0f, (float)chunkY}, 1.0f, WHITE);
+void Chunk::renderGrass(float time, float density) {
+    grass.render(time, density);
 }
 
 // Draw water wireframe
 void Chunk::renderWaterWires() {
+    if (!tiles.hasWater()) return;
     rlDisableBackfaceCulling();
     DrawModelWires(tiles.waterModel, {(float)chunkX, 0.0f, (float)chunkY}, 1.0f, WHITE);
     rlEnableBackfaceCulling();
 }
 
+// Grass is left to chunkManager::updateGrass
 void Chunk::generateMesh() {
-    using clock = std::chrono::high_resolution_clock;
+    generateTerrain();
+    buildMesh();
+    uploadMesh();
+}
 
+void Chunk::generateTerrain() {
+    PROFILE_SCOPE("Chunk::generateTerrain");
     int baseGenOffset[6] = {chunkX, chunkY, chunkX+1000, chunkY+1000, chunkX+2000, chunkY+2000};
 
     tiles.generatePerlinTerrain(0.75f, 90, 4, 0.25f, 2.0f, 1.2f, baseGenOffset);
+    state = ChunkState::DATA;
+}
+
+void Chunk::restoreTerrain(const CompressedTiles& data) {
+    PROFILE_SCOPE("Chunk::restoreTerrain");
+    if (!ChunkCache::decompress(data, tiles)) {
+        generateTerrain();
+        return;
+    }
+    state = ChunkState::DATA;
+}
 
-    tiles.generateMesh();
-    tiles.generateWaterMesh();
+void Chunk::buildMesh() {
+    PROFILE_SCOPE("Chunk::buildMesh");
+    tiles.buildMeshData(pendingMesh.terrain);
+    tiles.buildWaterMeshData(pendingMesh.water);
+    // Generation went through setTile(); these props already cover it
+    tiles.consumePropsDirty();
+    PropField::build(pendingMesh.props, tiles, chunkX, chunkY);
+    meshPending = true;
+    state = ChunkState::MESHED;
+}
 
-    // Generate grass
-    generateGrassData();
+void Chunk::uploadMesh() {
+    uploadTerrain();
+}
 
-    model = tiles.model;
-    Shader& shader = resourceManager::getShader(0);
-    for (int i = 0; i < model.materialCount; ++i) {
-        model.materials[i].shader = shader;
-    }
-    meshGenerated = true;
+void Chunk::queueUploads(MeshUploadQueue& queue) {
+    if (!meshPending) return;
+    // Terrain, water and props go together so the grid never sees one without the others
+    queue.push(this, pendingMesh.byteSize(), [this] { uploadTerrain(); });
+}
+
+void Chunk::uploadTerrain() {
+    if (!meshPending) return;
+    tiles.uploadMesh(std::move(pendingMesh.terrain));
+    tiles.uploadWaterMesh(std::move(pendingMesh.water));
+    props.upload(pendingMesh.props);
+    meshPending = false;
+    state = ChunkState::UPLOADED;
+}
+
+bool Chunk::uploadGrass(const GrassInstanceData& data, uint32_t revision) {
+    if (revision != grassRevision) return false;
+    grass.upload(data);
+    grassLoaded = true;
+    return true;
 }
 
+void Chunk::releaseGrass() {
+    grass.clear();
+    grassLoaded = false;
+}
+
+// Rebuild loaded grass in place after an edit (main thread)
 void Chunk::generateGrassData() {
-    // Collect tile data for grass generation
-    int w = CHUNKSIZE;
-    int h = CHUNKSIZE;
-    
-    std::vector<float> heights;
-    std::vector<uint8_t> types;
-    std::vector<uint8_t> temps;
-    std::vector<uint8_t> moists;
-    std::vector<uint8_t> bios;
-    std::vector<uint8_t> erosions;
-    
-    // Heights: (w+1) x (h+1) corner vertices
-    heights.resize((w + 1) * (h + 1));
-    for (int z = 0; z <= h; ++z) {
-        for (int x = 0; x <= w; ++x) {
-            // Get height from corner - tiles store 4 corners [0]=TL, [1]=TR, [2]=BR, [3]=BL
-            int tx = std::min(x, w - 1);
-            int tz = std::min(z, h - 1);
-            tile t = tiles.getTile(tx, tz);
-            
-            // Figure out which corner this is
-            int cornerIdx;
-            if (x == tx && z == tz) cornerIdx = 0;       // Top-left
-            else if (x == tx + 1 && z == tz) cornerIdx = 1;  // Top-right
-            else if (x == tx + 1 && z == tz + 1) cornerIdx = 2; // Bottom-right
-            else cornerIdx = 3; // Bottom-left
-            
-            heights[z * (w + 1) + x] = t.tileHeight[cornerIdx];
-        }
-    }
-    
-    // Per-tile data
-    std::vector<BiomeType> biomes;
-    biomes.resize(w * h);
-    types.resize(w * h); // Kept for debug/other uses if needed, though grass doesn't use it now
-    temps.resize(w * h);
-    moists.resize(w * h);
-    bios.resize(w * h);
-    erosions.resize(w * h);
-    
-    for (int z = 0; z < h; ++z) {
-        for (int x = 0; x < w; ++x) {
-            tile t = tiles.getTile(x, z);
-            int idx = z * w + x;
-            biomes[idx] = t.biome;
-            types[idx] = static_cast<uint8_t>(t.type);
-            temps[idx] = t.temperature;
-            moists[idx] = t.moisture;
-            bios[idx] = t.biologicalPotential;
-            erosions[idx] = t.erosionFactor;
-        }
-    }
-    
-    grass.generate(chunkX, chunkY, w, h, heights, biomes, temps, moists, bios, erosions);
+    GrassTileView view;
+    GrassInstanceData data;
+    uint32_t revision = viewGrassTiles(view);
+    GrassField::build(data, view);
+    uploadGrass(data, revision);
 }
 
+uint32_t Chunk::viewGrassTiles(GrassTileView& out) {
+    // Anything dirty is covered by a build from this view
+    tiles.consumeGrassDirty();
+
+    out.tiles = &tiles;
+    out.originX = chunkX;
+    out.originZ = chunkY;
+    out.width = CHUNKSIZE;
+    out.height = CHUNKSIZE;
+    return grassRevision;
+}
+
+// Apply tile edits made since the last update. Only the dirty rows of the
+// terrain and water meshes are re-emitted; grass and props are rebuilt only
+// when an edit changed data that their placement depends on. Edits made while the
+// built meshes still wait for upload are applied once they are on the GPU.
 void Chunk::updateMesh() {
-    tiles.generateMesh();
-    tiles.generateWaterMesh();
-    generateGrassData();
-    model = tiles.model;
-    // Reapply shared terrain shader
-    Shader& shader = resourceManager::getShader(0);
-    for (int i = 0; i < model.materialCount; ++i) {
-        model.materials[i].shader = shader;
+    if (!isUploaded()) return;
+    tiles.updateDirtyMesh();
+    if (tiles.consumeGrassDirty()) {
+        // Blades built from an older snapshot are dropped on upload
+        grassRevision++;
+        if (grassLoaded) generateGrassData();
+    }
+    if (tiles.consumePropsDirty()) {
+        // A few hundred candidates per type: cheap enough to redo here.
+        // The pending props are free scratch once the mesh is uploaded.
+        PropField::build(pendingMesh.props, tiles, chunkX, chunkY);
+        props.upload(pendingMesh.props);
     }
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "../include/chunkCache.hpp"
+#include "../include/profiling.hpp"
+#include "../include/scratchArena.hpp"
+#include <cmath>
+#include <iterator>
+
+// Per-tile byte fields stored as planes after biome, secondaryBiome and type
+static uint8_t tile::* const BYTE_FIELDS[] = {
+    &tile::moisture, &tile::temperature,
+    &tile::magmaticPotential, &tile::sulfidePotential, &tile::hydrologicalPotential,
+    &tile::biologicalPotential, &tile::crystalinePotential,
+    &tile::secondaryType, &tile::blendStrength, &tile::erosionFactor,
+    &tile::waterLevel, &tile::flowDir, &tile::riverWidth, &tile::riverCase,
+};
+static constexpr int BYTE_FIELD_COUNT = sizeof(BYTE_FIELDS) / sizeof(BYTE_FIELDS[0]);
+static constexpr int PLANE_COUNT = 3 + BYTE_FIELD_COUNT;
+static constexpr float HEIGHT_SCALE = 4.0f;  // Quarter units
+
+// Byte helpers take any byte vector: the cache's own storage or scratch
+template <typename Bytes>
+static void writeVarint(uint32_t value, Bytes& out) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+template <typename Bytes>
+static bool readVarint(const Bytes& in, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= in.size()) return false;
+        uint8_t b = in[pos++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Signed deltas interleaved onto unsigned so small magnitudes stay small
+static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// PackBits: header n < 128 is followed by n + 1 literal bytes, n > 128
+// repeats the next byte 257 - n times
+static void packBits(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+    size_t n = in.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 128 && in[i + run] == in[i]) run++;
+        if (run >= 2) {
+            out.push_back((uint8_t)(257 - run));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        // Literals up to the next run of three or more
+        size_t start = i;
+        while (i < n && i - start < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            i++;
+        }
+        out.push_back((uint8_t)(i - start - 1));
+        out.insert(out.end(), in.begin() + start, in.begin() + i);
+    }
+}
+
+template <typename Bytes>
+static bool unpackBits(const std::vector<uint8_t>& in, Bytes& out) {
+    size_t i = 0;
+    while (i < in.size()) {
+        uint8_t header = in[i++];
+        if (header < 128) {
+            size_t count = header + 1;
+            if (i + count > in.size()) return false;
+            out.insert(out.end(), in.begin() + i, in.begin() + i + count);
+            i += count;
+        } else if (header > 128) {
+            if (i >= in.size()) return false;
+            out.insert(out.end(), 257 - header, in[i++]);
+        }
+    }
+    return true;
+}
+
+void ChunkCache::compress(tileGrid& grid, CompressedTiles& out) {
+    PROFILE_SCOPE("ChunkCache::compress");
+    const int w = (int)grid.getWidth();
+    const int h = (int)grid.getHeight();
+    const int n = w * h;
+
+    std::vector<uint8_t> raw(PLANE_COUNT * n);
+    std::vector<int32_t> heights(4 * n);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            tile t = grid.getTile(x, y);
+            int i = y * w + x;
+            raw[i] = static_cast<uint8_t>(t.biome);
+            raw[n + i] = static_cast<uint8_t>(t.secondaryBiome);
+            raw[2 * n + i] = static_cast<uint8_t>(t.type);
+            for (int f = 0; f < BYTE_FIELD_COUNT; ++f) {
+                raw[(3 + f) * n + i] = t.*BYTE_FIELDS[f];
+            }
+            for (int c = 0; c < 4; ++c) {
+                heights[c * n + i] = (int32_t)std::lround(t.tileHeight[c] * HEIGHT_SCALE);
+            }
+        }
+    }
+
+    // Each corner plane is coded as deltas along the row-major tile order
+    for (int c = 0; c < 4; ++c) {
+        int32_t prev = 0;
+        for (int i = 0; i < n; ++i) {
+            int32_t q = heights[c * n + i];
+            writeVarint(zigzag(q - prev), raw);
+            prev = q;
+        }
+    }
+
+    out.bytes.clear();
+    packBits(raw, out.bytes);
+    out.bytes.shrink_to_fit();
+    out.rawSize = (uint32_t)raw.size();
+    out.width = (uint16_t)w;
+    out.height = (uint16_t)h;
+}
+
+bool ChunkCache::decompress(const CompressedTiles& in, tileGrid& grid) {
+    PROFILE_SCOPE("ChunkCache::decompress");
+    const int w = (int)grid.getWidth();
+    const int h = (int)grid.getHeight();
+    const int n = w * h;
+    if (in.width != w || in.height != h) return false;
+
+    ScratchScope scratch;
+    std::pmr::vector<uint8_t> raw(scratch.resource());
+    raw.reserve(in.rawSize);
+    if (!unpackBits(in.bytes, raw) || raw.size() != in.rawSize) return false;
+    if (raw.size() < (size_t)PLANE_COUNT * n) return false;
+
+    std::pmr::vector<int32_t> heights(4 * n, scratch.resource());
+    size_t pos = (size_t)PLANE_COUNT * n;
+    for (int c = 0; c < 4; ++c) {
+        int32_t prev = 0;
+        for (int i = 0; i < n; ++i) {
+            uint32_t v;
+            if (!readVarint(raw, pos, v)) return false;
+            prev += unzigzag(v);
+            heights[c * n + i] = prev;
+        }
+    }
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int i = y * w + x;
+            tile t;
+            t.biome = static_cast<BiomeType>(raw[i]);
+            t.secondaryBiome = static_cast<BiomeType>(raw[n + i]);
+            t.type = static_cast<char>(raw[2 * n + i]);
+            t.lighting = 0;
+            for (int f = 0; f < BYTE_FIELD_COUNT; ++f) {
+                t.*BYTE_FIELDS[f] = raw[(3 + f) * n + i];
+            }
+            for (int c = 0; c < 4; ++c) {
+                t.tileHeight[c] = heights[c * n + i] / HEIGHT_SCALE;
+            }
+            grid.setTile(x, y, t);
+        }
+    }
+    return true;
+}
+
+void ChunkCache::insert(uint64_t key, CompressedTiles&& data) {
+    auto existing = entries.find(key);
+    if (existing != entries.end()) erase(existing);
+
+    bytes += data.bytes.size();
+    rawBytes += data.rawSize;
+    order.push_back(key);
+    Entry& entry = entries[key];
+    entry.data = std::move(data);
+    entry.order = std::prev(order.end());
+
+    while (bytes > maxBytes && !order.empty()) {
+        erase(entries.find(order.front()));
+        PROFILE_COUNT("warm cache evictions", 1);
+    }
+}
+
+bool ChunkCache::take(uint64_t key, CompressedTiles& out) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    bytes -= it->second.data.bytes.size();
+    rawBytes -= it->second.data.rawSize;
+    out = std::move(it->second.data);
+    order.erase(it->second.order);
+    entries.erase(it);
+    return true;
+}
+
+void ChunkCache::clear() {
+    entries.clear();
+    order.clear();
+    bytes = 0;
+    rawBytes = 0;
+}
+
+void ChunkCache::erase(std::unordered_map<uint64_t, Entry>::iterator it) {
+    bytes -= it->second.data.bytes.size();
+    rawBytes -= it->second.data.rawSize;
+    order.erase(it->second.order);
+    entries.erase(it);
+}
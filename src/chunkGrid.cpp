@@ -0,0 +1,23 @@
+#include "../include/chunkGrid.hpp"
+
+ChunkGrid::ChunkGrid(int halfExtent)
+    : halfExtent(halfExtent), side(2 * halfExtent + 1), slots((size_t)side * side) {}
+
+void ChunkGrid::insert(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk) {
+    Slot& slot = slotFor(coord);
+    if (!slot.chunk) count++;
+    slot.coord = coord;
+    slot.chunk = std::move(chunk);
+}
+
+std::unique_ptr<Chunk> ChunkGrid::take(const ChunkCoord& coord) {
+    Slot& slot = slotFor(coord);
+    if (!slot.chunk || !(slot.coord == coord)) return nullptr;
+    count--;
+    return std::move(slot.chunk);
+}
+
+void ChunkGrid::clear() {
+    for (Slot& slot : slots) slot.chunk.reset();
+    count = 0;
+}
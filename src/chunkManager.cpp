@@ -2,123 +2,877 @@
 #include "raylib.h"
 #include "cmath"
 #include <algorithm>
+#include <chrono>
+#include "../include/profiling.hpp"
+#include "../include/visualSettings.hpp"
+#include "../include/resourceManager.hpp"
+#include "../include/scratchArena.hpp"
+#include "raymath.h"
+#include "rlgl.h"
 
-chunkManager::chunkManager(int loadRadius) : radius(loadRadius), lastCenter({-99999, -99999}) {}
-chunkManager::~chunkManager() = default;
+// Chunk offsets for each NeighborDir slot (E, SE, S, SW, W, NW, N, NE)
+static const int NEIGHBOR_DX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int NEIGHBOR_DY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// Worker job ids and warm-cache keys are packed chunk coordinates. x keeps
+// 31 bits (chunk coordinates stay far below 2^30), leaving the top bit to
+// tell grass jobs from chunk jobs.
+static constexpr uint64_t GRASS_JOB_BIT = 1ull << 63;
+
+static uint64_t packCoord(const ChunkCoord& coord) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x) & 0x7FFFFFFFu) << 32) | static_cast<uint32_t>(coord.y);
+}
+
+static ChunkCoord unpackCoord(uint64_t id) {
+    // Sign-extend x from 31 bits
+    int32_t x = static_cast<int32_t>(static_cast<uint32_t>(id >> 32) << 1) >> 1;
+    return {x, static_cast<int32_t>(id & 0xFFFFFFFFu)};
+}
+
+static uint64_t grassJobId(const ChunkCoord& coord) {
+    return packCoord(coord) | GRASS_JOB_BIT;
+}
+
+chunkManager::chunkManager(int loadRadius)
+    : chunks(loadRadius + UNLOAD_MARGIN), radius(loadRadius), lastCenter({-99999, -99999}) {}
+
+chunkManager::~chunkManager() {
+    // Running jobs stop after their current stage; the pool joins its threads first
+    for (auto& pair : pending) {
+        pair.second->cancelled = true;
+        workers.cancel(packCoord(pair.first));
+    }
+    for (auto& pair : grassPending) {
+        pair.second->cancelled = true;
+        while (workers.cancel(grassJobId(pair.first))) {}
+    }
+}
 
 void chunkManager::update(const Camera& cam) {
+    // Chunks may be unloaded below; cullChunks() rebuilds the list
+    visible.clear();
+    ++cullFrame;
+
     int centerX = static_cast<int>(floor(cam.position.x / CHUNKSIZE));
     int centerY = static_cast<int>(floor(cam.position.z / CHUNKSIZE));
 
+    viewPos = {cam.position.x, cam.position.z};
+    cameraPos = cam.position;
+    Vector2 forward = {cam.target.x - cam.position.x, cam.target.z - cam.position.z};
+    float forwardLen = sqrtf(forward.x * forward.x + forward.y * forward.y);
+    if (forwardLen > 1e-4f) viewDir = {forward.x / forwardLen, forward.y / forwardLen};
+
+    // Apply pending tile edits; only dirty rows are re-emitted
+    for (ChunkGrid::Slot& slot : chunks) {
+        if (slot.chunk->tiles.hasDirtyTiles()) {
+            slot.chunk->updateMesh();
+            updateWaterEntry(slot.coord, slot.chunk.get());
+        }
+    }
+
+    // Hand finished background chunks to the world, then upload within the frame budget
+    collectFinished();
+    uploads.drain();
+    processRetired();
+    updateGrass();
+
     ChunkCoord currentCenter{centerX, centerY};
-    if (currentCenter == lastCenter) return;
+    if (!(currentCenter == lastCenter)) {
+        for(int dx = -radius; dx <= radius; ++dx) {
+            for(int dy = -radius; dy <= radius; ++dy) {
+                requestChunk({currentCenter.x + dx, currentCenter.y + dy});
+            }
+        }
+
+        cancelDistant(currentCenter);
+        unloadDistant(currentCenter);
+        lastCenter = currentCenter;
+        sortWaterOrder();
+    }
+
+    // The camera may have moved or turned since the requests were queued
+    if (!pending.empty()) {
+        workers.reprioritize([this](uint64_t id) { return chunkPriority(unpackCoord(id)); });
+    }
+    PROFILE_SET("chunk jobs pending", (int64_t)pending.size());
+    PROFILE_SET("chunks pooled", (int64_t)chunkPool.size());
+    PROFILE_SET("warm cache entries", (int64_t)warmCache.getEntryCount());
+    PROFILE_SET("warm cache KB", (int64_t)(warmCache.getBytes() / 1024));
+    PROFILE_SET("warm cache hits", (int64_t)warmCache.getHits());
+    PROFILE_SET("warm cache misses", (int64_t)warmCache.getMisses());
+    PROFILE_VALUE("warm cache hit rate %", warmCache.getHitRate() * 100.0);
+    if (warmCache.getBytes() > 0) {
+        PROFILE_VALUE("warm cache compression ratio", (double)warmCache.getRawBytes() / warmCache.getBytes());
+    }
+    PROFILE_SET("scratch arena KB", ScratchArena::getReservedBytes() / 1024);
+    PROFILE_SET("heap allocs in scratch scopes", ScratchArena::getScopedHeapAllocations());
+#ifdef TILEGRID_PROFILE
+    Profiler& profiler = Profiler::getInstance();
+    int64_t swaps = profiler.getCount("chunks streamed in");
+    if (swaps > 0) {
+        PROFILE_VALUE("gl objects created per chunk swap", (double)profiler.getCount("gl objects created") / swaps);
+    }
+#endif
+}
+
+void chunkManager::cullChunks() {
+    PROFILE_SCOPE("chunkManager::cullChunks");
+    Matrix viewProj = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    frustum = Frustum::fromMatrix(viewProj);
+    cullStats = CullStats{};
+    ++cullFrame;
+
+    visible.clear();
+    for (ChunkGrid::Slot& slot : chunks) {
+        BoundingBox bounds = slot.chunk->getBounds();
+        if (!frustum.intersects(bounds)) {
+            cullStats.frustumCulled++;
+            continue;
+        }
+        visible.push_back({slot.coord, slot.chunk.get(), bounds});
+    }
 
-    for(int dx = -radius; dx <= radius; ++dx) {
-        for(int dy = -radius; dy <= radius; ++dy) {
-            ensureChunk(currentCenter.x + dx, currentCenter.y + dy);
+    horizonActive = horizonCulling;
+    if (horizonCulling) {
+        // Front to back, so near chunks occlude the ones behind them
+        std::sort(visible.begin(), visible.end(), [this](const VisibleChunk& a, const VisibleChunk& b) {
+            float ax = (a.coord.x + 0.5f) * CHUNKSIZE - viewPos.x, az = (a.coord.y + 0.5f) * CHUNKSIZE - viewPos.y;
+            float bx = (b.coord.x + 0.5f) * CHUNKSIZE - viewPos.x, bz = (b.coord.y + 0.5f) * CHUNKSIZE - viewPos.y;
+            return ax * ax + az * az < bx * bx + bz * bz;
+        });
+        horizon.reset(viewProj);
+        size_t kept = 0;
+        for (const VisibleChunk& v : visible) {
+            if (horizon.occludes(v.bounds)) {
+                cullStats.horizonCulled++;
+                continue;
+            }
+            // Only terrain that is actually drawn can hide anything
+            const HeightBounds& terrain = v.chunk->tiles.getHeightBounds();
+            if (v.chunk->isUploaded() && terrain.minH <= terrain.maxH) {
+                horizon.addOccluder(v.bounds.min.x, v.bounds.min.z, v.bounds.max.x, v.bounds.max.z, terrain.minH);
+            }
+            visible[kept++] = v;
         }
+        visible.resize(kept);
     }
 
-    unloadDistant(currentCenter);
-    lastCenter = currentCenter;
+    for (VisibleChunk& v : visible) {
+        v.chunk->visibleFrame = cullFrame;
+        v.lod = selectLod(v.bounds);
+        cullStats.lodChunks[v.lod]++;
+        cullStats.terrainVertices += v.chunk->tiles.getLodVertexCount(v.lod);
+    }
+    cullStats.drawn = (int)visible.size();
+    PROFILE_SET("chunks drawn", cullStats.drawn);
+    PROFILE_SET("chunks culled (frustum)", cullStats.frustumCulled);
+    PROFILE_SET("chunks culled (horizon)", cullStats.horizonCulled);
+    PROFILE_SET("terrain vertices drawn", cullStats.terrainVertices);
+}
+
+int chunkManager::selectLod(const BoundingBox& bounds) const {
+    if (!lodEnabled) return 0;
+    // Distance to the nearest point of the box, so a tall chunk right under
+    // a raised camera still counts as near
+    float dx = cameraPos.x - std::clamp(cameraPos.x, bounds.min.x, bounds.max.x);
+    float dy = cameraPos.y - std::clamp(cameraPos.y, bounds.min.y, bounds.max.y);
+    float dz = cameraPos.z - std::clamp(cameraPos.z, bounds.min.z, bounds.max.z);
+    float distSq = dx * dx + dy * dy + dz * dz;
+    int lod = 0;
+    while (lod < TERRAIN_LOD_LEVELS - 1 && distSq > lodDistances[lod] * lodDistances[lod]) lod++;
+    return lod;
+}
+
+bool chunkManager::isVisible(const BoundingBox& box) const {
+    if (!frustum.intersects(box)) return false;
+    return !(horizonActive && horizon.occludes(box));
 }
 
 void chunkManager::render() {
-    // First pass: draw all opaque terrain
-    for (auto& pair : chunks) {
-        pair.second->renderTerrain();
-    }
-    // Second pass: draw all transparent water layers in a stable order
-    // Gather chunks into a vector and sort by chunk coordinates
-    std::vector<std::pair<ChunkCoord, Chunk*>> items;
-    items.reserve(chunks.size());
-    for (auto& pair : chunks) {
-        items.emplace_back(pair.first, pair.second.get());
-    }
-    std::sort(items.begin(), items.end(), [](auto& a, auto& b) {
-        if (a.first.x != b.first.x) return a.first.x < b.first.x;
-        return a.first.y < b.first.y;
-    });
-    for (auto& entry : items) {
-        entry.second->renderWater();
+    // First pass: opaque terrain, merged into a few draws per region
+    renderTerrainBatched();
+    // Second pass: transparent water, back to front. waterOrder only holds
+    // chunks with water and is already sorted.
+    int waterDrawn = 0;
+    for (const WaterEntry& entry : waterOrder) {
+        if (entry.chunk->visibleFrame != cullFrame) continue;
+        entry.chunk->renderWater();
+        waterDrawn++;
     }
+    PROFILE_SET("water chunks drawn", waterDrawn);
 }
 
 void chunkManager::renderGrass(float time, const Camera& cam) {
-    // Distance culling - only render grass for nearby chunks
-    const float grassCullDistance = 100.0f;  // Max distance for grass rendering
-    const float grassCullDistSq = grassCullDistance * grassCullDistance;
-    
-    for (auto& pair : chunks) {
-        // Calculate chunk center in world coords
-        float chunkCenterX = (pair.first.x + 0.5f) * CHUNKSIZE;
-        float chunkCenterZ = (pair.first.y + 0.5f) * CHUNKSIZE;
-        
-        // Distance from camera to chunk center (XZ plane only)
-        float dx = chunkCenterX - cam.position.x;
-        float dz = chunkCenterZ - cam.position.z;
-        float distSq = dx*dx + dz*dz;
-        
-        if (distSq < grassCullDistSq) {
-            pair.second->renderGrass(time);
+    // Distance culling on top of cullChunks(). Chunks in the release margin
+    // keep their grass but do not draw it.
+    const GrassSettings& settings = VisualSettings::getInstance().getGrassSettings();
+    Vector2 pos = {cam.position.x, cam.position.z};
+    int drawn = 0;
+    int64_t blades = 0;
+    for (const VisibleChunk& v : visible) {
+        float distance = chunkDistance(v.coord, pos);
+        if (!v.chunk->hasGrass() || distance > settings.renderDistance) continue;
+        // Density of the chunk's nearest point: an upper bound for all its
+        // blades, the shader thins the farther ones continuously
+        float density = settings.lodDensity(distance);
+        v.chunk->renderGrass(time, density);
+        blades += (int64_t)std::ceil(v.chunk->grass.getBladeCount() * density);
+        drawn++;
+    }
+    cullStats.grassBlades = blades;
+    PROFILE_SET("grass chunks drawn", drawn);
+    PROFILE_SET("grass blades drawn", blades);
+}
+
+void chunkManager::renderProps(const Camera& cam) {
+    Shader& shader = resourceManager::getPropShader();
+    PropShaderLocs& locs = resourceManager::getPropShaderLocs();
+    rlEnableShader(shader.id);
+
+    // Instance positions are chunk-local, so every chunk shares one MVP
+    Matrix matMVP = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()),
+                                   rlGetMatrixProjection());
+    if (locs.mvp != -1) rlSetUniformMatrix(locs.mvp, matMVP);
+    Vector3 trunkColor = {0.32f, 0.22f, 0.14f};
+    if (locs.trunkColor != -1) rlSetUniform(locs.trunkColor, &trunkColor, SHADER_UNIFORM_VEC3, 1);
+
+    Vector2 pos = {cam.position.x, cam.position.z};
+    int64_t props = 0;
+    int draws = 0;
+    for (int t = 0; t < PROP_TYPE_COUNT; ++t) {
+        PropType type = static_cast<PropType>(t);
+        float lodStart = PropField::getLodStart(type);
+        float lodEnd = PropField::getMaxDistance(type);
+        if (locs.lodStart != -1) rlSetUniform(locs.lodStart, &lodStart, SHADER_UNIFORM_FLOAT, 1);
+        if (locs.lodEnd != -1) rlSetUniform(locs.lodEnd, &lodEnd, SHADER_UNIFORM_FLOAT, 1);
+        for (const VisibleChunk& v : visible) {
+            float distance = chunkDistance(v.coord, pos);
+            if (distance > lodEnd) continue;
+            // Density of the chunk's nearest point, as for grass
+            float density = PropField::lodDensity(type, distance);
+            if (!v.chunk->props.draw(type, density)) continue;
+            props += (int64_t)std::ceil(v.chunk->props.getInstanceCount(type) * density);
+            draws++;
         }
     }
+    rlDisableShader();
+
+    cullStats.props = props;
+    cullStats.propDraws = draws;
+    PROFILE_SET("props drawn", props);
+    PROFILE_SET("prop draws", draws);
 }
 
 void chunkManager::renderDataPoint(Color a, Color b, uint8_t tile::*dataMember) {
-    for(auto& pair : chunks) {
-        pair.second->tiles.renderDataPoint(a, b, dataMember, pair.first.x * CHUNKSIZE, pair.first.y * CHUNKSIZE);
+    for (const VisibleChunk& v : visible) {
+        v.chunk->tiles.renderDataPoint(a, b, dataMember, v.coord.x * CHUNKSIZE, v.coord.y * CHUNKSIZE);
     }
 }
 
 void chunkManager::renderWires() {
     // Draw terrain wireframes
-    for (auto& pair : chunks) {
-        pair.second->renderWires();
-    }
+    rlEnableWireMode();
+    renderTerrainBatched();
+    rlDisableWireMode();
     // Draw water wireframes
-    for (auto& pair : chunks) {
-        pair.second->renderWaterWires();
+    for (const VisibleChunk& v : visible) {
+        v.chunk->renderWaterWires();
+    }
+}
+
+void chunkManager::renderTerrainBatched() {
+    // Marks carry this frame's cull stamp, so chunks culled since the last
+    // pass are left out without clearing anything
+    for (const VisibleChunk& v : visible) {
+        v.chunk->markTerrain(v.lod, cullFrame);
     }
+    cullStats.terrainDrawCalls = TerrainArenas::getInstance().draw(cullFrame);
+    PROFILE_SET("terrain draw calls", cullStats.terrainDrawCalls);
 }
 
 Chunk* chunkManager::getChunk(int cx, int cy) {
-    return ensureChunk(cx, cy);
+    return chunks.find({cx, cy});
 }
 
-Chunk* chunkManager::ensureChunk(int cx, int cy) {
+Chunk* chunkManager::loadChunkNow(int cx, int cy) {
     ChunkCoord key{cx, cy};
-    auto it = chunks.find(key);
-    if(it != chunks.end()) return it->second.get();
+    if (Chunk* loaded = getChunk(cx, cy)) return loaded;
 
-    // Create and store new chunk; actual mesh generation deferred to Chunk::render
-    auto ptr = std::make_unique<Chunk>(cx * CHUNKSIZE, cy * CHUNKSIZE);
-    Chunk* raw = ptr.get();
-    chunks.emplace(key, std::move(ptr));
+    // Redoing the work here is simpler than waiting behind the worker queue
+    cancelJob(key);
+    flushRetired(key);
+    std::unique_ptr<Chunk> chunk = acquireChunk(key);
+    CompressedTiles cached;
+    if (warmCache.take(packCoord(key), cached)) {
+        chunk->restoreTerrain(cached);
+    } else {
+        chunk->generateTerrain();
+    }
+    chunk->buildMesh();
+    chunk->uploadMesh();
+    Chunk* raw = chunk.get();
+    installChunk(key, std::move(chunk));
     return raw;
 }
 
-void chunkManager::unloadDistant(const ChunkCoord& center) {
-    for(auto it = chunks.begin(); it != chunks.end();) {
-        int dx = it->first.x - center.x;
-        int dy = it->first.y - center.y;
-        if(abs(dx) > radius || abs(dy) > radius) {
-            it = chunks.erase(it);
-        } else {
+void chunkManager::requestChunk(const ChunkCoord& coord) {
+    if (chunks.contains(coord) || pending.count(coord)) return;
+
+    auto job = std::make_shared<ChunkJob>();
+    job->coord = coord;
+    flushRetired(coord);
+    job->chunk = acquireChunk(coord);
+    // A recently unloaded chunk skips the WorldMap queries
+    job->warm = warmCache.take(packCoord(coord), job->cached);
+    pending.emplace(coord, job);
+
+    // The chunk is not linked to any neighbour until it is installed, so the
+    // worker only touches this chunk and the (thread-safe) WorldMap
+    workers.submit(packCoord(coord), chunkPriority(coord), [job] {
+        // Build scratch comes from this worker's arena and is dropped
+        // with the scope, so a steady stream of chunks stays off the heap
+        ScratchScope scratch;
+        if (!job->cancelled) {
+            if (job->warm) {
+                job->chunk->restoreTerrain(job->cached);
+            } else {
+                job->chunk->generateTerrain();
+            }
+        }
+        if (!job->cancelled) {
+            job->chunk->buildMesh();
+            job->finished = true;
+        }
+        job->settled = true;
+    });
+}
+
+void chunkManager::cancelJob(const ChunkCoord& coord) {
+    auto it = pending.find(coord);
+    if (it == pending.end()) return;
+    it->second->cancelled = true;
+    if (workers.cancel(packCoord(coord))) {
+        // Never started, so the chunk can be recycled right away
+        ChunkJob& job = *it->second;
+        if (job.warm) warmCache.insert(packCoord(coord), std::move(job.cached));
+        retireChunk(std::move(job.chunk), coord, false);
+    } else {
+        cancelling.push_back(it->second);
+    }
+    pending.erase(it);
+    PROFILE_COUNT("chunk jobs cancelled", 1);
+}
+
+bool chunkManager::outsideBand(const ChunkCoord& coord, const ChunkCoord& center) const {
+    int keep = radius + UNLOAD_MARGIN;
+    return abs(coord.x - center.x) > keep || abs(coord.y - center.y) > keep;
+}
+
+void chunkManager::cancelDistant(const ChunkCoord& center) {
+    std::vector<ChunkCoord> distant;
+    for (const auto& pair : pending) {
+        if (outsideBand(pair.first, center)) {
+            distant.push_back(pair.first);
+        }
+    }
+    for (const ChunkCoord& coord : distant) {
+        cancelJob(coord);
+    }
+}
+
+void chunkManager::collectFinished() {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (!it->second->finished) {
+            ++it;
+            continue;
+        }
+        installChunk(it->first, std::move(it->second->chunk));
+        it = pending.erase(it);
+    }
+}
+
+void chunkManager::installChunk(const ChunkCoord& coord, std::unique_ptr<Chunk> chunk) {
+    PROFILE_COUNT("chunks streamed in", 1);
+    Chunk* raw = chunk.get();
+    // Only a chunk outside the unload band (loadChunkNow before the first
+    // update) can hold the slot; it would be unloaded anyway
+    ChunkGrid::Slot& slot = chunks.slotFor(coord);
+    if (slot.chunk) unloadChunk(slot.coord);
+    chunks.insert(coord, std::move(chunk));
+    linkNeighbors(coord, raw);
+    // No-op for chunks that were already uploaded (loadChunkNow)
+    raw->queueUploads(uploads);
+    updateWaterEntry(coord, raw);
+    if (!raw->isUploaded()) {
+        // Runs right after the chunk's own uploads; cancelled along with them
+        uploads.push(raw, 0, [this, coord, raw] { updateWaterEntry(coord, raw); });
+    }
+}
+
+std::unique_ptr<Chunk> chunkManager::acquireChunk(const ChunkCoord& coord) {
+    std::unique_ptr<Chunk> chunk;
+    if (!chunkPool.empty()) {
+        chunk = std::move(chunkPool.back());
+        chunkPool.pop_back();
+    } else if (!retiring.empty()) {
+        // Nothing reset yet: pay for the oldest retired chunk's reset now
+        recycleChunk(retiring.front());
+        chunk = std::move(retiring.front().chunk);
+        retiring.pop_front();
+    }
+
+    if (chunk) {
+        PROFILE_COUNT("chunks recycled", 1);
+        chunk->setOrigin(coord.x * CHUNKSIZE, coord.y * CHUNKSIZE);
+        return chunk;
+    }
+    PROFILE_COUNT("chunks allocated", 1);
+    return std::make_unique<Chunk>(coord.x * CHUNKSIZE, coord.y * CHUNKSIZE);
+}
+
+void chunkManager::retireChunk(std::unique_ptr<Chunk> chunk, const ChunkCoord& coord, bool cacheTiles) {
+    if (!chunk) return;
+    uploads.cancel(chunk.get());
+    retiring.push_back({coord, std::move(chunk), cacheTiles});
+}
+
+void chunkManager::recycleChunk(RetiredChunk& retired) {
+    if (retired.cacheTiles) {
+        CompressedTiles data;
+        ChunkCache::compress(retired.chunk->tiles, data);
+        warmCache.insert(packCoord(retired.coord), std::move(data));
+        retired.cacheTiles = false;
+    }
+    retired.chunk->reset();
+}
+
+void chunkManager::flushRetired(const ChunkCoord& coord) {
+    for (RetiredChunk& retired : retiring) {
+        if (!retired.cacheTiles || !(retired.coord == coord)) continue;
+        CompressedTiles data;
+        ChunkCache::compress(retired.chunk->tiles, data);
+        warmCache.insert(packCoord(coord), std::move(data));
+        retired.cacheTiles = false;
+    }
+}
+
+void chunkManager::processRetired() {
+    for (auto it = cancelling.begin(); it != cancelling.end();) {
+        ChunkJob& job = **it;
+        if (!job.settled) {
             ++it;
+            continue;
+        }
+        // The job never reached the world; hand its warm entry back
+        if (job.warm) warmCache.insert(packCoord(job.coord), std::move(job.cached));
+        retireChunk(std::move(job.chunk), job.coord, false);
+        it = cancelling.erase(it);
+    }
+
+    // Reset a few retired chunks into the pool; once it is full, destroy
+    // the surplus one chunk per frame
+    for (int i = 0; i < RETIRE_PER_FRAME && !retiring.empty(); ++i) {
+        RetiredChunk retired = std::move(retiring.front());
+        retiring.pop_front();
+        recycleChunk(retired);
+        if (chunkPool.size() >= poolCapacity()) {
+            PROFILE_COUNT("chunks destroyed", 1);
+            break;  // retired.chunk is released here
+        }
+        chunkPool.push_back(std::move(retired.chunk));
+    }
+}
+
+float chunkManager::chunkPriority(const ChunkCoord& coord) const {
+    float dx = (coord.x + 0.5f) * CHUNKSIZE - viewPos.x;
+    float dz = (coord.y + 0.5f) * CHUNKSIZE - viewPos.y;
+    float dist = sqrtf(dx * dx + dz * dz);
+    if (dist < 1e-3f) return 0.0f;
+
+    // -1 directly behind the camera, 1 straight ahead; a chunk ahead ranks
+    // like one at half the distance behind
+    float facing = (dx * viewDir.x + dz * viewDir.y) / dist;
+    return -dist * (1.0f - 0.25f * (facing + 1.0f));
+}
+
+bool chunkManager::raycastTile(const Ray& ray, TileHit& hit, Chunk** hitChunk) {
+    // Nothing beyond the loaded square can be hit
+    const float maxDistance = (2 * radius + 2) * CHUNKSIZE * 1.5f;
+
+    GridWalker walker(ray, (float)CHUNKSIZE, 0.0f);
+    for (; walker.t < maxDistance; walker.step()) {
+        Chunk* chunk = chunks.find({walker.cx, walker.cy});
+        if (!chunk) continue;
+
+        // Chunk meshes are local to the chunk origin
+        float originX = (float)(walker.cx * CHUNKSIZE);
+        float originZ = (float)(walker.cy * CHUNKSIZE);
+        Ray local = ray;
+        local.position.x -= originX;
+        local.position.z -= originZ;
+
+        float exit = std::min(walker.exitT(), maxDistance);
+        if (chunk->tiles.raycast(local, walker.t, exit, hit)) {
+            hit.x += walker.cx * CHUNKSIZE;
+            hit.y += walker.cy * CHUNKSIZE;
+            hit.point.x += originX;
+            hit.point.z += originZ;
+            if (hitChunk) *hitChunk = chunk;
+            return true;
+        }
+    }
+    return false;
+}
+
+Vector3 chunkManager::pickTile(const Ray& ray, const Camera&) {
+    TileHit hit;
+    if (!raycastTile(ray, hit)) return Vector3{-1, -1, -1};
+    return Vector3{(float)hit.x, (float)hit.y, hit.point.y};
+}
+
+double chunkManager::benchmarkPicking(const Camera& cam, int rayCount) {
+    if (rayCount <= 0) return 0.0;
+
+    // Build the rays up front so only the picks are timed
+    int side = std::max(1, (int)std::sqrt((float)rayCount));
+    std::vector<Ray> rays;
+    rays.reserve(side * side);
+    for (int j = 0; j < side; ++j) {
+        for (int i = 0; i < side; ++i) {
+            Vector2 screen = {(i + 0.5f) * GetScreenWidth() / side, (j + 0.5f) * GetScreenHeight() / side};
+            rays.push_back(GetMouseRay(screen, cam));
+        }
+    }
+
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Ray& ray : rays) {
+        TileHit hit;
+        if (raycastTile(ray, hit)) hits++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double picksPerSecond = elapsed.count() > 0.0 ? rays.size() / elapsed.count() : 0.0;
+    TraceLog(LOG_INFO, "Pick benchmark: %zu rays, %d hits, %.0f picks/s", rays.size(), hits, picksPerSecond);
+    return picksPerSecond;
+}
+
+void chunkManager::linkNeighbors(const ChunkCoord& coord, Chunk* chunk) {
+    for (int dir = 0; dir < 8; ++dir) {
+        Chunk* other = chunks.find({coord.x + NEIGHBOR_DX[dir], coord.y + NEIGHBOR_DY[dir]});
+        if (!other) continue;
+        // The opposite slot is four steps around the D8 ring
+        chunk->tiles.setNeighbor(dir, &other->tiles);
+        other->tiles.setNeighbor((dir + 4) % 8, &chunk->tiles);
+    }
+}
+
+void chunkManager::unlinkNeighbors(const ChunkCoord& coord) {
+    for (int dir = 0; dir < 8; ++dir) {
+        Chunk* other = chunks.find({coord.x + NEIGHBOR_DX[dir], coord.y + NEIGHBOR_DY[dir]});
+        if (!other) continue;
+        other->tiles.setNeighbor((dir + 4) % 8, nullptr);
+    }
+}
+
+void chunkManager::unloadChunk(const ChunkCoord& coord) {
+    cancelGrass(coord);
+    unlinkNeighbors(coord);
+    removeWaterEntry(coord);
+    retireChunk(chunks.take(coord), coord, true);
+}
+
+void chunkManager::unloadDistant(const ChunkCoord& center) {
+    // Called before lastCenter moves: only the edge the band left behind
+    // can hold chunks that are now outside it
+    chunks.forEachLeaving(lastCenter, center, [&](ChunkGrid::Slot& slot) {
+        if (outsideBand(slot.coord, center)) unloadChunk(slot.coord);
+    });
+}
+
+float chunkManager::chunkDistance(const ChunkCoord& coord, Vector2 pos) {
+    float minX = (float)(coord.x * CHUNKSIZE);
+    float minZ = (float)(coord.y * CHUNKSIZE);
+    float dx = std::max({minX - pos.x, 0.0f, pos.x - (minX + CHUNKSIZE)});
+    float dz = std::max({minZ - pos.y, 0.0f, pos.y - (minZ + CHUNKSIZE)});
+    return sqrtf(dx * dx + dz * dz);
+}
+
+void chunkManager::updateGrass() {
+    // Other grass settings are shader uniforms and need nothing here
+    GrassPlacementParams placement = GrassPlacementParams::current();
+    if (placement != grassPlacement) {
+        grassPlacement = placement;
+        rebuildGrass();
+    }
+
+    // Finished builds go through the upload budget like meshes
+    for (auto& pair : grassPending) {
+        std::shared_ptr<GrassJob> job = pair.second;
+        if (!job->finished || job->queued) continue;
+        job->queued = true;
+        ChunkCoord coord = pair.first;
+        // Still loaded: unloading cancels the job and the chunk's uploads
+        Chunk* chunk = chunks.find(coord);
+        uploads.push(chunk, job->data.byteSize(), [this, coord, chunk, job] {
+            if (job->cancelled) return;
+            grassPending.erase(coord);
+            if (!chunk->uploadGrass(job->data, job->revision)) {
+                // Edited since the snapshot; requested again below
+                PROFILE_COUNT("grass builds discarded", 1);
+            }
+        });
+    }
+
+    // Build inside the radius, free beyond the margin, leave the band between alone
+    float buildDistance = VisualSettings::getInstance().getGrassSettings().renderDistance;
+    float releaseDistance = buildDistance + GRASS_RELEASE_MARGIN;
+    size_t loaded = 0;
+    for (ChunkGrid::Slot& slot : chunks) {
+        Chunk* chunk = slot.chunk.get();
+        if (!chunk->isUploaded()) continue;
+        float distance = chunkDistance(slot.coord, viewPos);
+        if (distance <= buildDistance) {
+            if (!chunk->hasGrass() && !grassPending.count(slot.coord)) requestGrass(slot.coord, chunk);
+        } else if (distance > releaseDistance) {
+            cancelGrass(slot.coord);
+            if (chunk->hasGrass()) {
+                chunk->releaseGrass();
+                PROFILE_COUNT("grass chunks released", 1);
+            }
         }
+        if (chunk->hasGrass()) loaded++;
+    }
+    PROFILE_SET("grass chunks loaded", (int64_t)loaded);
+    PROFILE_SET("grass builds pending", (int64_t)grassPending.size());
+}
+
+void chunkManager::requestGrass(const ChunkCoord& coord, Chunk* chunk) {
+    auto job = std::make_shared<GrassJob>();
+    // Planning reads the tiles in place, so it runs here while they cannot
+    // change; the row bands only read the plan and go to the pool under one
+    // id. Whichever band finishes last sorts the result.
+    GrassTileView view;
+    job->revision = chunk->viewGrassTiles(view);
+    GrassField::planBuild(job->plan, job->data, view);
+    grassPending.emplace(coord, job);
+    int rows = job->plan.height;
+    int bands = std::max(1, (rows + GRASS_ROWS_PER_BAND - 1) / GRASS_ROWS_PER_BAND);
+    job->remaining = bands;
+    float priority = chunkPriority(coord);
+    uint64_t id = grassJobId(coord);
+    for (int band = 0; band < bands; ++band) {
+        workers.submit(id, priority, [job, band] {
+            if (job->cancelled) return;
+            int rowBegin = band * GRASS_ROWS_PER_BAND;
+            int rowEnd = std::min(job->plan.height, rowBegin + GRASS_ROWS_PER_BAND);
+            GrassField::placeRows(job->plan, job->data, rowBegin, rowEnd);
+            if (--job->remaining > 0) return;
+            GrassField::finishBuild(job->plan, job->data);
+            job->finished = true;
+        });
+    }
+    PROFILE_COUNT("grass builds requested", 1);
+}
+
+void chunkManager::rebuildGrass() {
+    PROFILE_COUNT("grass placement rebuilds", 1);
+    for (ChunkGrid::Slot& slot : chunks) {
+        Chunk* chunk = slot.chunk.get();
+        cancelGrass(slot.coord);
+        // Chunks without grass yet are requested again by updateGrass()
+        if (chunk->hasGrass()) requestGrass(slot.coord, chunk);
+    }
+}
+
+void chunkManager::cancelGrass(const ChunkCoord& coord) {
+    auto it = grassPending.find(coord);
+    if (it == grassPending.end()) return;
+    // A running build finishes into a job nobody holds any more
+    it->second->cancelled = true;
+    // One queued entry per row band not yet started
+    while (workers.cancel(grassJobId(coord))) {}
+    grassPending.erase(it);
+}
+
+// Farthest first; ties by coordinate so the order never flickers
+static bool drawsBefore(float distA, const ChunkCoord& a, float distB, const ChunkCoord& b) {
+    if (distA != distB) return distA > distB;
+    if (a.x != b.x) return a.x < b.x;
+    return a.y < b.y;
+}
+
+void chunkManager::updateWaterEntry(const ChunkCoord& coord, Chunk* chunk) {
+    auto it = std::find_if(waterOrder.begin(), waterOrder.end(),
+                           [&](const WaterEntry& e) { return e.coord == coord; });
+    bool listed = it != waterOrder.end();
+    bool hasWater = chunk->tiles.hasWater();
+    if (listed == hasWater) return;
+    if (listed) {
+        waterOrder.erase(it);
+        return;
     }
+
+    float dx = (coord.x + 0.5f) * CHUNKSIZE - waterOrigin.x;
+    float dz = (coord.y + 0.5f) * CHUNKSIZE - waterOrigin.y;
+    WaterEntry entry{coord, chunk, dx * dx + dz * dz};
+    auto pos = std::upper_bound(waterOrder.begin(), waterOrder.end(), entry, [](const WaterEntry& a, const WaterEntry& b) {
+        return drawsBefore(a.distSq, a.coord, b.distSq, b.coord);
+    });
+    waterOrder.insert(pos, entry);
+}
+
+void chunkManager::removeWaterEntry(const ChunkCoord& coord) {
+    auto it = std::find_if(waterOrder.begin(), waterOrder.end(),
+                           [&](const WaterEntry& e) { return e.coord == coord; });
+    if (it != waterOrder.end()) waterOrder.erase(it);
+}
+
+void chunkManager::sortWaterOrder() {
+    PROFILE_COUNT("water order sorts", 1);
+    waterOrigin = viewPos;
+    for (WaterEntry& entry : waterOrder) {
+        float dx = (entry.coord.x + 0.5f) * CHUNKSIZE - waterOrigin.x;
+        float dz = (entry.coord.y + 0.5f) * CHUNKSIZE - waterOrigin.y;
+        entry.distSq = dx * dx + dz * dz;
+    }
+    std::sort(waterOrder.begin(), waterOrder.end(), [](const WaterEntry& a, const WaterEntry& b) {
+        return drawsBefore(a.distSq, a.coord, b.distSq, b.coord);
+    });
 }
 
 void chunkManager::clearAllChunks() {
+    // Workers read the WorldMap; let running jobs stop before anything is torn down
+    for (auto& pair : pending) {
+        pair.second->cancelled = true;
+        workers.cancel(packCoord(pair.first));
+        cancelling.push_back(pair.second);
+    }
+    pending.clear();
+    for (auto& pair : grassPending) {
+        pair.second->cancelled = true;
+        while (workers.cancel(grassJobId(pair.first))) {}
+    }
+    grassPending.clear();
+    workers.waitIdle();
+
+    // Everything is recycled into the next world; the surplus is freed over
+    // the next frames. Cached tiles belong to the old world.
+    uploads.clear();
+    visible.clear();
+    waterOrder.clear();
+    for (auto& job : cancelling) retireChunk(std::move(job->chunk), job->coord, false);
+    cancelling.clear();
+    for (ChunkGrid::Slot& slot : chunks) retireChunk(std::move(slot.chunk), slot.coord, false);
     chunks.clear();
+    for (RetiredChunk& retired : retiring) retired.cacheTiles = false;
+    warmCache.clear();
     lastCenter = {-99999, -99999};  // Force reload on next update
 }
 
 size_t chunkManager::getTotalGrassBlades() const {
     size_t total = 0;
-    for (const auto& pair : chunks) {
-        total += pair.second->grass.getBladeCount();
+    for (const ChunkGrid::Slot& slot : chunks) {
+        total += slot.chunk->grass.getBladeCount();
+    }
+    return total;
+}
+
+size_t chunkManager::getGrassGpuBytes() const {
+    size_t total = 0;
+    for (const ChunkGrid::Slot& slot : chunks) {
+        total += slot.chunk->grass.getGpuBytes();
+    }
+    return total;
+}
+
+size_t chunkManager::getGrassChunkCount() const {
+    size_t count = 0;
+    for (const ChunkGrid::Slot& slot : chunks) {
+        if (slot.chunk->hasGrass()) count++;
+    }
+    return count;
+}
+
+size_t chunkManager::getTerrainGpuBytes() const {
+    size_t total = 0;
+    for (const ChunkGrid::Slot& slot : chunks) {
+        total += slot.chunk->tiles.getTerrainGpuBytes();
     }
     return total;
 }
+
+size_t chunkManager::getTerrainVertexCount() const {
+    size_t total = 0;
+    for (const ChunkGrid::Slot& slot : chunks) {
+        total += slot.chunk->tiles.getTerrainVertexCount();
+    }
+    return total;
+}
+
+double chunkManager::benchmarkPacking(int iterations, bool normalTable) {
+    if (chunks.empty()) return 0.0;
+    double totalMs = 0.0;
+    for (ChunkGrid::Slot& slot : chunks) {
+        totalMs += slot.chunk->tiles.benchmarkPacking(iterations, normalTable);
+    }
+    double msPerChunk = totalMs / chunks.size();
+    TraceLog(LOG_INFO, "Packing benchmark: %zu chunks, %.3f ms/chunk", chunks.size(), msPerChunk);
+    return msPerChunk;
+}
+
+chunkManager::ContainerBenchmark chunkManager::benchmarkChunkAccess(int iterations) {
+    ContainerBenchmark result;
+    if (chunks.empty() || iterations <= 0) return result;
+
+    std::unordered_map<ChunkCoord, Chunk*> map;
+    for (const ChunkGrid::Slot& slot : chunks) map.emplace(slot.coord, slot.chunk.get());
+    // Every coordinate of the unload band: mostly hits, some misses
+    std::vector<ChunkCoord> probes;
+    int keep = radius + UNLOAD_MARGIN;
+    for (int dy = -keep; dy <= keep; ++dy) {
+        for (int dx = -keep; dx <= keep; ++dx) {
+            probes.push_back({lastCenter.x + dx, lastCenter.y + dy});
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto nsPer = [](clock::duration elapsed, size_t count) {
+        return std::chrono::duration<double, std::nano>(elapsed).count() / (double)count;
+    };
+    uintptr_t sink = 0;
+
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const ChunkCoord& coord : probes) sink += (uintptr_t)chunks.find(coord);
+    }
+    result.gridLookupNs = nsPer(clock::now() - start, (size_t)iterations * probes.size());
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const ChunkCoord& coord : probes) {
+            auto it = map.find(coord);
+            if (it != map.end()) sink += (uintptr_t)it->second;
+        }
+    }
+    result.mapLookupNs = nsPer(clock::now() - start, (size_t)iterations * probes.size());
+
+    // Walks touch each chunk, like the render loops
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const ChunkGrid::Slot& slot : chunks) sink += slot.chunk->isUploaded();
+    }
+    result.gridIterateNs = nsPer(clock::now() - start, (size_t)iterations * chunks.size());
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& pair : map) sink += pair.second->isUploaded();
+    }
+    result.mapIterateNs = nsPer(clock::now() - start, (size_t)iterations * map.size());
+
+    volatile uintptr_t keepSink = sink;
+    (void)keepSink;
+    TraceLog(LOG_INFO, "Chunk access benchmark: lookup %.1f ns (grid) / %.1f ns (map), iterate %.1f ns (grid) / %.1f ns (map)",
+             result.gridLookupNs, result.mapLookupNs, result.gridIterateNs, result.mapIterateNs);
+    return result;
+}
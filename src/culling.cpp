@@ -0,0 +1,148 @@
+#include "../include/culling.hpp"
+#include <raymath.h>
+#include "rlgl.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Same convention as raylib's Vector3Transform: clip.x = m0*x + m4*y + m8*z + m12,
+// so each clip coordinate is one "row" of the named fields
+Frustum Frustum::fromMatrix(const Matrix& m) {
+    const Vector4 rowX = {m.m0, m.m4, m.m8, m.m12};
+    const Vector4 rowY = {m.m1, m.m5, m.m9, m.m13};
+    const Vector4 rowZ = {m.m2, m.m6, m.m10, m.m14};
+    const Vector4 rowW = {m.m3, m.m7, m.m11, m.m15};
+    auto add = [](Vector4 a, Vector4 b) { return Vector4{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; };
+    auto sub = [](Vector4 a, Vector4 b) { return Vector4{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; };
+
+    Frustum f;
+    f.planes[0] = add(rowW, rowX);  // Left
+    f.planes[1] = sub(rowW, rowX);  // Right
+    f.planes[2] = add(rowW, rowY);  // Bottom
+    f.planes[3] = sub(rowW, rowY);  // Top
+    f.planes[4] = add(rowW, rowZ);  // Near
+    f.planes[5] = sub(rowW, rowZ);  // Far
+    return f;
+}
+
+Frustum Frustum::fromCurrentMatrices() {
+    return fromMatrix(MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+}
+
+bool Frustum::intersects(const BoundingBox& box) const {
+    for (const Vector4& p : planes) {
+        // Corner furthest along the plane normal
+        float x = p.x >= 0.0f ? box.max.x : box.min.x;
+        float y = p.y >= 0.0f ? box.max.y : box.min.y;
+        float z = p.z >= 0.0f ? box.max.z : box.min.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+void HorizonBuffer::reset(const Matrix& newViewProj) {
+    viewProj = newViewProj;
+    std::fill(coveredLo, coveredLo + BINS, 1.0f);
+    std::fill(coveredHi, coveredHi + BINS, -1.0f);
+}
+
+bool HorizonBuffer::project(Vector3 p, float& x, float& y) const {
+    const Matrix& m = viewProj;
+    float w = m.m3 * p.x + m.m7 * p.y + m.m11 * p.z + m.m15;
+    if (w <= 1e-4f) return false;
+    x = (m.m0 * p.x + m.m4 * p.y + m.m8 * p.z + m.m12) / w;
+    y = (m.m1 * p.x + m.m5 * p.y + m.m9 * p.z + m.m13) / w;
+    return true;
+}
+
+bool HorizonBuffer::occludes(const BoundingBox& box) const {
+    float x0 = FLT_MAX, x1 = -FLT_MAX, y0 = FLT_MAX, y1 = -FLT_MAX;
+    for (int i = 0; i < 8; ++i) {
+        Vector3 corner = {(i & 1) ? box.max.x : box.min.x,
+                          (i & 2) ? box.max.y : box.min.y,
+                          (i & 4) ? box.max.z : box.min.z};
+        float sx, sy;
+        if (!project(corner, sx, sy)) return false;
+        x0 = std::min(x0, sx);
+        x1 = std::max(x1, sx);
+        y0 = std::min(y0, sy);
+        y1 = std::max(y1, sy);
+    }
+
+    // Only the on-screen part has to be covered
+    x0 = std::max(x0, -1.0f);
+    x1 = std::min(x1, 1.0f);
+    y0 = std::max(y0, -1.0f);
+    y1 = std::min(y1, 1.0f);
+    if (x0 > x1 || y0 > y1) return false;
+
+    int b0 = std::clamp((int)((x0 + 1.0f) * 0.5f * BINS), 0, BINS - 1);
+    int b1 = std::clamp((int)((x1 + 1.0f) * 0.5f * BINS), 0, BINS - 1);
+    for (int b = b0; b <= b1; ++b) {
+        if (y0 < coveredLo[b] || y1 > coveredHi[b]) return false;
+    }
+    return true;
+}
+
+void HorizonBuffer::addOccluder(float x0, float z0, float x1, float z1, float y) {
+    const Vector3 corners[4] = {{x0, y, z0}, {x1, y, z0}, {x1, y, z1}, {x0, y, z1}};
+    float px[4], py[4];
+    float minX = FLT_MAX, maxX = -FLT_MAX;
+    for (int i = 0; i < 4; ++i) {
+        if (!project(corners[i], px[i], py[i])) return;
+        minX = std::min(minX, px[i]);
+        maxX = std::max(maxX, px[i]);
+    }
+
+    // Vertical extent of the projected quad at screen x
+    auto slice = [&](float x, float& lo, float& hi) {
+        lo = FLT_MAX;
+        hi = -FLT_MAX;
+        for (int i = 0; i < 4; ++i) {
+            int j = (i + 1) % 4;
+            float ex0 = std::min(px[i], px[j]);
+            float ex1 = std::max(px[i], px[j]);
+            if (x < ex0 || x > ex1) continue;
+            if (ex1 - ex0 < 1e-6f) {
+                // Vertical edge: the whole edge lies on this line
+                lo = std::min(lo, std::min(py[i], py[j]));
+                hi = std::max(hi, std::max(py[i], py[j]));
+                continue;
+            }
+            float sy = py[i] + (x - px[i]) * (py[j] - py[i]) / (px[j] - px[i]);
+            lo = std::min(lo, sy);
+            hi = std::max(hi, sy);
+        }
+    };
+
+    const float binWidth = 2.0f / BINS;
+    for (int b = 0; b < BINS; ++b) {
+        float xa = -1.0f + b * binWidth;
+        float xb = xa + binWidth;
+        if (xa < minX || xb > maxX) continue;
+
+        // The quad projects to a convex polygon, so what it covers over the
+        // whole bin is the overlap of its slices at the bin edges
+        float loA, hiA, loB, hiB;
+        slice(xa, loA, hiA);
+        slice(xb, loB, hiB);
+        float lo = std::max(loA, loB);
+        float hi = std::min(hiA, hiB);
+        if (lo >= hi) continue;
+
+        float& curLo = coveredLo[b];
+        float& curHi = coveredHi[b];
+        if (curLo > curHi) {
+            curLo = lo;
+            curHi = hi;
+        } else if (lo <= curHi && hi >= curLo) {
+            // Overlapping: take the union
+            curLo = std::min(curLo, lo);
+            curHi = std::max(curHi, hi);
+        } else if (hi - lo > curHi - curLo) {
+            // Disjoint: keep the larger interval
+            curLo = lo;
+            curHi = hi;
+        }
+    }
+}
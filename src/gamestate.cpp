@@ -9,6 +9,7 @@
 #include "../include/biome.hpp"
 #include "../include/worldMap.hpp"
 #include "../include/visualSettings.hpp"
+#include "../include/profiling.hpp"
 
 Camera resourceManager::camera;
 Vector3 cameraPosition = {32.0f, 32.0f, 32.0f};
@@ -54,9 +55,10 @@ void gameState::init() {
     // Link managers
     machineManagement.world = &world;
 
-    // Load initial chunks and setup center chunk
+    // Load the origin chunk right away (initial items sit on it); the rest
+    // stream in from the workers
+    Chunk* center = world.loadChunkNow(0, 0);
     world.update(camera);
-    Chunk* center = world.getChunk(0, 0);
     center->tiles.updateLighting(
         sunData.sunDirection, sunData.sunColor,
         sunData.ambientStrength, sunData.ambientColor,
@@ -82,8 +84,9 @@ void gameState::update() {
     
     // Handle terrain regeneration request
     if (shouldRegenerateTerrain) {
-        WorldMap::getInstance().clear();
+        // Chunks first: clearing waits for workers still reading the WorldMap
         world.clearAllChunks();
+        WorldMap::getInstance().clear();
         shouldRegenerateTerrain = false;
     }
     
@@ -109,9 +112,9 @@ void gameState::update() {
     // Machine Inspection Logic
     if (IsMouseButtonPressed(MOUSE_MIDDLE_BUTTON)) {
         Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
-        Vector3 hitVoxel = world.getChunk(0, 0)->tiles.getTileIndexDDA(mouseRay);
-        if (hitVoxel.x != -1) {
-            inspectedMachine = machineManagement.getMachineAt({(int)hitVoxel.x, (int)hitVoxel.y});
+        TileHit hit;
+        if (world.raycastTile(mouseRay, hit)) {
+            inspectedMachine = machineManagement.getMachineAt({hit.x, hit.y});
         } else {
             inspectedMachine = nullptr;
         }
@@ -120,9 +123,9 @@ void gameState::update() {
     // Machine Deletion Logic
     if (IsKeyPressed(KEY_X)) {
         Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
-        Vector3 hitVoxel = world.getChunk(0, 0)->tiles.getTileIndexDDA(mouseRay);
-        if (hitVoxel.x != -1) {
-            machineManagement.removeMachineAt({(int)hitVoxel.x, (int)hitVoxel.y});
+        TileHit hit;
+        if (world.raycastTile(mouseRay, hit)) {
+            machineManagement.removeMachineAt({hit.x, hit.y});
         }
     }
 
@@ -142,21 +145,25 @@ void gameState::update() {
             std::cout << "Left-click registered in-game." << std::endl;
             // Ray-pick across loaded chunks
             Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
-            Vector3 hitVoxel = world.getChunk(0, 0)->tiles.getTileIndexDDA(mouseRay);
-            if (hitVoxel.x != -1 && buildMode) {
-                std::cout << "Build conditions met. Placing machine at: " << hitVoxel.x << ", " << hitVoxel.y << std::endl;
+            TileHit hit;
+            Chunk* hitChunk = nullptr;
+            if (world.raycastTile(mouseRay, hit, &hitChunk) && buildMode) {
+                std::cout << "Build conditions met. Placing machine at: " << hit.x << ", " << hit.y << std::endl;
+                // Machines live in world space; the tile grid is addressed chunk-locally
+                int localX = hit.x - (int)floor((float)hit.x / CHUNKSIZE) * CHUNKSIZE;
+                int localY = hit.y - (int)floor((float)hit.y / CHUNKSIZE) * CHUNKSIZE;
+                float groundHeight = hitChunk->tiles.getTile(localX, localY).tileHeight[0];
                 std::unique_ptr<machine> newMachine;
                 if (placementType == DRILLMK1) {
-                    newMachine = std::make_unique<drillMk1>(Vector3{hitVoxel.x, world.getChunk(0, 0)->tiles.getTile(hitVoxel.x, hitVoxel.y).tileHeight[0], hitVoxel.y});
+                    newMachine = std::make_unique<drillMk1>(Vector3{(float)hit.x, groundHeight, (float)hit.y});
                 } else {
-                    newMachine = std::make_unique<conveyorMk1>(Vector3{hitVoxel.x, world.getChunk(0, 0)->tiles.getTile(hitVoxel.x, hitVoxel.y).tileHeight[0], hitVoxel.y});
+                    newMachine = std::make_unique<conveyorMk1>(Vector3{(float)hit.x, groundHeight, (float)hit.y});
                 }
 
                 newMachine->dir = placementDirection;
-                // For now, assuming placement is on center chunk, so local coords are global coords.
-                newMachine->globalPos = {(int)hitVoxel.x, (int)hitVoxel.y};
+                newMachine->globalPos = {hit.x, hit.y};
 
-                if(world.getChunk(0, 0)->tiles.placeMachine(hitVoxel.x, hitVoxel.y, newMachine.get())){
+                if(hitChunk->tiles.placeMachine(localX, localY, newMachine.get())){
                     machineManagement.addMachine(std::move(newMachine));
                 }
             }
@@ -176,6 +183,7 @@ void gameState::render() {
         resourceManager::updateWaterTime(GetTime());
         
         BeginMode3D(camera);
+        world.cullChunks();
         rlDisableBackfaceCulling();
         switch(renderMode) {
             case 0: 
@@ -195,6 +203,9 @@ void gameState::render() {
                     sunData.shiftIntensity, sunData.shiftDisplacement
                 );
                 world.renderGrass(static_cast<float>(GetTime()), camera);
+                resourceManager::updatePropUniforms(camera.position, sunData.sunDirection, sunData.sunColor,
+                                                    sunData.ambientStrength, sunData.ambientColor);
+                world.renderProps(camera);
              break;
             case 2:
                 switch (debugOpt) {
@@ -229,14 +240,112 @@ void gameState::render() {
         ImGui::Combo("mode", &debugOpt, "moisture\0temperature\0magmatic potential\0sulfide potential\0hydrological potential\0biological potential\0crystaline potential\0");
         ImGui::Separator();
         ImGui::Checkbox("Settings Panel", &showVisualSettings);
+        ImGui::Checkbox("Profiler", &showProfiler);
         ImGui::Separator();
         ImGui::Text("Grass blades: %zu", world.getTotalGrassBlades());
+        ImGui::Text("Grass chunks: %zu (%zu building)", world.getGrassChunkCount(), world.getPendingGrassCount());
+        if (ImGui::Button("Benchmark picking")) {
+            pickBenchmarkRate = world.benchmarkPicking(camera, 10000);
+            PROFILE_VALUE("picks per second", pickBenchmarkRate);
+        }
+        if (pickBenchmarkRate > 0.0) {
+            ImGui::SameLine();
+            ImGui::Text("%.0f picks/s", pickBenchmarkRate);
+        }
+        if (world.getChunkCount() > 0) {
+            double chunkCount = (double)world.getChunkCount();
+            double packedKB = world.getTerrainGpuBytes() / 1024.0 / chunkCount;
+            double floatKB = world.getTerrainVertexCount() * FLOAT_TERRAIN_VERTEX_BYTES / 1024.0 / chunkCount;
+            ImGui::Text("Terrain VRAM/chunk: %.1f KB (float layout %.1f KB)", packedKB, floatKB);
+        }
+        if (world.getGrassChunkCount() > 0) {
+            // Per chunk that has grass at all
+            double grassChunks = (double)world.getGrassChunkCount();
+            double grassKB = world.getGrassGpuBytes() / 1024.0 / grassChunks;
+            double matrixKB = world.getTotalGrassBlades() * FLOAT_GRASS_INSTANCE_BYTES / 1024.0 / grassChunks;
+            ImGui::Text("Grass VRAM/chunk: %.1f KB (mat4 layout %.1f KB)", grassKB, matrixKB);
+        }
+        bool useNormalTable = tileGrid::useNormalTable.load(std::memory_order_relaxed);
+        if (ImGui::Checkbox("Normal lookup table", &useNormalTable)) {
+            tileGrid::useNormalTable.store(useNormalTable, std::memory_order_relaxed);
+        }
+        if (ImGui::Button("Benchmark packing")) {
+            // Time meshing with and without the normal table
+            packBenchmarkMs = world.benchmarkPacking(20, true);
+            packBenchmarkNoTableMs = world.benchmarkPacking(20, false);
+            PROFILE_VALUE("terrain pack ms/chunk", packBenchmarkMs);
+            PROFILE_VALUE("terrain pack ms/chunk (no normal table)", packBenchmarkNoTableMs);
+        }
+        if (packBenchmarkMs > 0.0) {
+            ImGui::Text("Packing: %.3f ms/chunk (table) / %.3f ms/chunk (computed)",
+                        packBenchmarkMs, packBenchmarkNoTableMs);
+        }
+        {
+            MeshUploadQueue& uploads = world.getUploadQueue();
+            MeshUploadQueue::Budget budget = uploads.getBudget();
+            float budgetMs = (float)budget.maxMs;
+            int budgetKB = (int)(budget.maxBytes / 1024);
+            bool changed = ImGui::SliderFloat("Upload budget (ms)", &budgetMs, 0.25f, 16.0f);
+            changed |= ImGui::SliderInt("Upload budget (KB)", &budgetKB, 64, 16384);
+            if (changed) {
+                budget.maxMs = budgetMs;
+                budget.maxBytes = (size_t)budgetKB * 1024;
+                uploads.setBudget(budget);
+            }
+            ImGui::Text("Pending uploads: %zu (%.1f KB)", uploads.getPendingCount(),
+                        uploads.getPendingBytes() / 1024.0);
+        }
+        ImGui::Text("Chunk jobs: %zu pending, %d running on %d workers", world.getPendingChunkCount(),
+                    world.getWorkers().getActiveCount(), world.getWorkers().getThreadCount());
+        ImGui::Text("Chunk pool: %zu ready, %zu retiring", world.getPooledChunkCount(),
+                    world.getRetiringChunkCount());
+        if (ImGui::Button("Benchmark chunk access")) {
+            chunkAccessBenchmark = world.benchmarkChunkAccess(1000);
+            PROFILE_VALUE("chunk lookup ns (grid)", chunkAccessBenchmark.gridLookupNs);
+            PROFILE_VALUE("chunk lookup ns (map)", chunkAccessBenchmark.mapLookupNs);
+            PROFILE_VALUE("chunk iterate ns (grid)", chunkAccessBenchmark.gridIterateNs);
+            PROFILE_VALUE("chunk iterate ns (map)", chunkAccessBenchmark.mapIterateNs);
+        }
+        if (chunkAccessBenchmark.gridLookupNs > 0.0) {
+            ImGui::Text("Lookup: %.1f ns (grid) / %.1f ns (map)", chunkAccessBenchmark.gridLookupNs,
+                        chunkAccessBenchmark.mapLookupNs);
+            ImGui::Text("Iterate: %.1f ns/chunk (grid) / %.1f ns/chunk (map)",
+                        chunkAccessBenchmark.gridIterateNs, chunkAccessBenchmark.mapIterateNs);
+        }
+        bool horizonCulling = world.getHorizonCulling();
+        if (ImGui::Checkbox("Horizon culling", &horizonCulling)) world.setHorizonCulling(horizonCulling);
+        const chunkManager::CullStats& cull = world.getCullStats();
+        ImGui::Text("Chunks drawn: %d (culled: %d frustum, %d horizon)", cull.drawn,
+                    cull.frustumCulled, cull.horizonCulled);
+        bool terrainLod = world.getTerrainLod();
+        if (ImGui::Checkbox("Terrain LOD", &terrainLod)) world.setTerrainLod(terrainLod);
+        const char* lodLabels[TERRAIN_LOD_LEVELS - 1] = {"LOD 1 distance", "LOD 2 distance"};
+        for (int level = 1; level < TERRAIN_LOD_LEVELS; ++level) {
+            float distance = world.getLodDistance(level);
+            if (ImGui::SliderFloat(lodLabels[level - 1], &distance, 16.0f, 512.0f)) {
+                world.setLodDistance(level, distance);
+            }
+        }
+        ImGui::Text("Terrain LOD chunks: %d / %d / %d, %d vertices", cull.lodChunks[0], cull.lodChunks[1],
+                    cull.lodChunks[2], cull.terrainVertices);
+        const TerrainArenas& arenas = TerrainArenas::getInstance();
+        ImGui::Text("Terrain draws: %d (%zu regions, %zu arenas, %.1f MB)", cull.terrainDrawCalls,
+                    arenas.getRegionCount(), arenas.getArenaCount(), arenas.getGpuBytes() / (1024.0 * 1024.0));
+        ImGui::Text("Grass blades drawn: %lld / %zu", (long long)cull.grassBlades, world.getTotalGrassBlades());
+        ImGui::Text("Props drawn: %lld (%d draws)", (long long)cull.props, cull.propDraws);
+        const ChunkCache& warmCache = world.getWarmCache();
+        ImGui::Text("Warm cache: %zu chunks, %.1f KB, %.0f%% hits", warmCache.getEntryCount(),
+                    warmCache.getBytes() / 1024.0, warmCache.getHitRate() * 100.0);
         ImGui::End();
         
         // Unified Settings Window (combines visual + world gen)
         if (showVisualSettings) {
             renderSettingsUI();
         }
+        
+        if (showProfiler) {
+            Profiler::getInstance().renderUI(&showProfiler);
+        }
 
         ImGui::Begin("Build");
         const char* direction_names[] = {"NORTH", "EAST", "SOUTH", "WEST"};
@@ -507,6 +616,8 @@ void gameState::renderSettingsUI() {
         ImGui::Text("Render Distance:");
         changed |= ImGui::SliderFloat("Render Distance##grass", &grass.renderDistance, 16.0f, 128.0f);
         changed |= ImGui::SliderFloat("Fade Start##grass", &grass.fadeStartDistance, 8.0f, 120.0f);
+        changed |= ImGui::SliderInt("LOD Levels##grass", &grass.lodLevels, 1, 4);
+        changed |= ImGui::SliderFloat("LOD Reduction##grass", &grass.lodReduction, 0.1f, 1.0f);
     }
     
     // ==================== WATER ====================
@@ -1,12 +1,16 @@
 #include "../include/grass.hpp"
+#include "../include/meshData.hpp"
+#include "../include/tileGrid.hpp"
 #include "../include/resourceManager.hpp"
 #include "../include/textureAtlas.hpp"
 #include "../include/visualSettings.hpp"
-#include "rlgl.h"
+#include "../include/profiling.hpp"
+#include "../include/rlglTypes.hpp"
 #include "raymath.h"
 #include <cmath>
 #include <algorithm>
 #include <cstring>
+#include <numeric>
 
 // Simple deterministic hash for pseudo-random values
 static uint32_t hash(uint32_t x) {
@@ -25,6 +29,51 @@ static float lerpf(float a, float b, float t) {
     return a + t * (b - a);
 }
 
+static uint8_t packUnorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+static uint16_t packFixed16(float v) {
+    return static_cast<uint16_t>(std::clamp(std::lround(v), 0L, 65535L));
+}
+
+PackedGrassInstance PackedGrassInstance::pack(float localX, float y, float localZ, float heightScale,
+                                              float heightJitter, Vector3 color, float diffuse,
+                                              float temperature, float lean, float stiffness,
+                                              float dirtDistance) {
+    PackedGrassInstance p;
+    p.position[0] = packFixed16(localX * POSITION_SCALE);
+    p.position[1] = packFixed16(y * HEIGHT_UNITS + HEIGHT_BIAS);
+    p.position[2] = packFixed16(localZ * POSITION_SCALE);
+
+    uint16_t r = static_cast<uint16_t>(std::lround(std::clamp(color.x, 0.0f, 1.0f) * 31.0f));
+    uint16_t g = static_cast<uint16_t>(std::lround(std::clamp(color.y, 0.0f, 1.0f) * 63.0f));
+    uint16_t b = static_cast<uint16_t>(std::lround(std::clamp(color.z, 0.0f, 1.0f) * 31.0f));
+    p.color = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+
+    p.heightScale = packUnorm8(heightScale / MAX_HEIGHT_SCALE);
+    p.diffuse = packUnorm8(diffuse);
+    p.temperature = packUnorm8(temperature);
+    p.lean = packUnorm8(lean / (2.0f * MAX_LEAN) + 0.5f);
+    p.stiffness = packUnorm8(stiffness);
+    p.heightJitter = packUnorm8(heightJitter);
+    p.dirtDistance = packUnorm8(dirtDistance / MAX_DIRT_DISTANCE);
+    p.reserved = 0;
+    return p;
+}
+
+GrassPlacementParams GrassPlacementParams::current() {
+    const GrassSettings& grass = VisualSettings::getInstance().getGrassSettings();
+    const TerrainSettings& terrain = VisualSettings::getInstance().getTerrainSettings();
+    GrassPlacementParams params;
+    params.bladesPerTile = grass.bladesPerTile;
+    params.minDensity = grass.minDensity;
+    params.slopeReduction = grass.slopeReduction;
+    params.erosionThreshold = terrain.erosionThreshold;
+    params.erosionFullExpose = terrain.erosionFullExpose;
+    return params;
+}
+
 GrassField::GrassField() {
     bladeMesh = {0};
     grassMaterial = {0};
@@ -32,14 +81,13 @@ GrassField::GrassField() {
     vboPositions = 0;
     vboTexcoords = 0;
     vboNormals = 0;
-    vboInstanceTransforms = 0;
-    vboInstanceColors = 0;
-    vboInstanceTemp = 0;
+    vboInstances = 0;
 }
 
 GrassField::~GrassField() {
     clear();
     if (meshGenerated) {
+        PROFILE_COUNT("gl objects deleted", 4);
         // Clean up our manually created buffers
         if (vboPositions != 0) rlUnloadVertexBuffer(vboPositions);
         if (vboTexcoords != 0) rlUnloadVertexBuffer(vboTexcoords);
@@ -49,21 +97,13 @@ GrassField::~GrassField() {
 }
 
 void GrassField::clear() {
-    transforms.clear();
-    bladeData.clear();
     bladeCount = 0;
+    instanceCapacity = 0;
     
-    if (vboInstanceTransforms != 0) {
-        rlUnloadVertexBuffer(vboInstanceTransforms);
-        vboInstanceTransforms = 0;
-    }
-    if (vboInstanceColors != 0) {
-        rlUnloadVertexBuffer(vboInstanceColors);
-        vboInstanceColors = 0;
-    }
-    if (vboInstanceTemp != 0) {
-        rlUnloadVertexBuffer(vboInstanceTemp);
-        vboInstanceTemp = 0;
+    if (vboInstances != 0) {
+        PROFILE_COUNT("gl objects deleted", 1);
+        rlUnloadVertexBuffer(vboInstances);
+        vboInstances = 0;
     }
 }
 
@@ -142,32 +182,12 @@ void GrassField::generateBladeMesh() {
     rlEnableVertexAttribute(2);
     
     rlDisableVertexArray();
+    PROFILE_COUNT("gl objects created", 4);
     
     meshGenerated = true;
     TraceLog(LOG_INFO, "GRASS: Billboard blade mesh created - VAO: %u, vertices: %d", vaoId, vertexCount);
 }
 
-float GrassField::getHeightAt(float localX, float localZ, int tileX, int tileZ,
-                              int width, const std::vector<float>& heights) const {
-    // Heights array is (width+1) x (height+1) for corner vertices
-    int stride = width + 1;
-    
-    // Get the four corner heights
-    float h00 = heights[tileZ * stride + tileX];
-    float h10 = heights[tileZ * stride + tileX + 1];
-    float h01 = heights[(tileZ + 1) * stride + tileX];
-    float h11 = heights[(tileZ + 1) * stride + tileX + 1];
-    
-    // Bilinear interpolation
-    float fx = localX - tileX;
-    float fz = localZ - tileZ;
-    
-    return h00 * (1 - fx) * (1 - fz) +
-           h10 * fx * (1 - fz) +
-           h01 * (1 - fx) * fz +
-           h11 * fx * fz;
-}
-
 Color GrassField::computeGrassColor(uint8_t temperature, uint8_t moisture,
                                     uint8_t biological, uint8_t tileType) const {
     // Get grass settings from VisualSettings
@@ -216,85 +236,144 @@ Color GrassField::computeGrassColor(uint8_t temperature, uint8_t moisture,
     };
 }
 
-void GrassField::generate(
-    int chunkWorldX, int chunkWorldZ,
-    int width, int height,
-    const std::vector<float>& tileHeights,
-    const std::vector<BiomeType>& biomes,
-    const std::vector<uint8_t>& temperatures,
-    const std::vector<uint8_t>& moistures,
-    const std::vector<uint8_t>& biologicalPotentials,
-    const std::vector<uint8_t>& erosionFactors
-) {
-    clear();
-    generateBladeMesh();
-    
-    // Get settings
-    const GrassSettings& settings = VisualSettings::getInstance().getGrassSettings();
-    const BiomeManager& biomeMan = BiomeManager::getInstance();
-    
-    // Estimate max blades and reserve
-    int bladesPerTile = static_cast<int>(settings.bladesPerTile);
-    int maxBlades = width * height * bladesPerTile;
-    transforms.reserve(maxBlades);
-    bladeData.reserve(maxBlades);
-    
-    auto idx = [width](int x, int z) { return z * width + x; };
-    
-    // Helper: check if tile at (x,z) is dirt-like (sand, stone, etc.)
-    // We use the biome's primary texture to determine this
-    auto isDirtLike = [&](int x, int z) -> bool {
-        if (x < 0 || x >= width || z < 0 || z >= height) return false;
-        BiomeType b = biomes[idx(x, z)];
-        uint8_t tex = biomeMan.getTopTexture(b);
-        return tex == SAND || tex == STONE || tex == SNOW;
+void GrassField::generate(const GrassTileView& view) {
+    GrassInstanceData data;
+    build(data, view);
+    upload(data);
+}
+
+void GrassField::build(GrassInstanceData& out, const GrassTileView& view) {
+    GrassBuildPlan plan;
+    planBuild(plan, out, view);
+    placeRows(plan, out, 0, view.height);
+    finishBuild(plan, out);
+}
+
+// Two-pass vector distance transform (8SSEDT): for every cell of a w x h
+// grid, the offset to about the nearest cell whose dirt flag equals site.
+// The first pass runs down the rows pulling offsets from the W, NW, N and NE
+// neighbours and then back along the row from E; the second runs up,
+// pulling from E, SE, S and SW and then from W.
+struct SiteOffset {
+    int dx, dz;
+};
+
+static constexpr int NO_SITE = 1 << 12;
+
+static void nearestSites(const std::vector<uint8_t>& dirt, uint8_t site, int w, int h, std::vector<SiteOffset>& out) {
+    out.assign((size_t)w * h, SiteOffset{NO_SITE, NO_SITE});
+    for (size_t i = 0; i < dirt.size(); ++i) {
+        if (dirt[i] == site) out[i] = {0, 0};
+    }
+    auto pull = [&](int x, int z, int nx, int nz) {
+        if (nx < 0 || nx >= w || nz < 0 || nz >= h) return;
+        SiteOffset cand = out[nz * w + nx];
+        if (cand.dx == NO_SITE) return;
+        cand.dx += nx - x;
+        cand.dz += nz - z;
+        SiteOffset& cur = out[z * w + x];
+        if (cur.dx == NO_SITE || cand.dx * cand.dx + cand.dz * cand.dz < cur.dx * cur.dx + cur.dz * cur.dz) {
+            cur = cand;
+        }
     };
-    
-    // Helper: calculate minimum distance to nearest dirt-like tile edge
-    auto distToDirt = [&](int tx, int tz, float localX, float localZ) -> float {
-        float minDist = 999.0f;
-        
-        // Check all 8 neighbors + center tile edges
-        for (int dz = -1; dz <= 1; ++dz) {
-            for (int dx = -1; dx <= 1; ++dx) {
-                if (isDirtLike(tx + dx, tz + dz)) {
-                    // Calculate distance from position to this neighbor
-                    float nx = tx + dx + 0.5f;
-                    float nz = tz + dz + 0.5f;
-                    float dist = sqrtf((localX - nx) * (localX - nx) + (localZ - nz) * (localZ - nz));
-                    // Subtract 0.5 to get distance from edge rather than center
-                    dist = std::max(0.0f, dist - 0.7f);
-                    minDist = std::min(minDist, dist);
-                }
-            }
+    for (int z = 0; z < h; ++z) {
+        for (int x = 0; x < w; ++x) {
+            pull(x, z, x - 1, z);
+            pull(x, z, x - 1, z - 1);
+            pull(x, z, x, z - 1);
+            pull(x, z, x + 1, z - 1);
+        }
+        for (int x = w - 1; x >= 0; --x) pull(x, z, x + 1, z);
+    }
+    for (int z = h - 1; z >= 0; --z) {
+        for (int x = w - 1; x >= 0; --x) {
+            pull(x, z, x + 1, z);
+            pull(x, z, x + 1, z + 1);
+            pull(x, z, x, z + 1);
+            pull(x, z, x - 1, z + 1);
         }
-        return minDist;
+        for (int x = 0; x < w; ++x) pull(x, z, x - 1, z);
+    }
+}
+
+// Signed distance from each cell centre to the edge of the nearest cell of the
+// other kind: positive on grass, negative on dirt-like cells
+void GrassField::buildDirtField(const std::vector<uint8_t>& dirt, int w, int h, std::vector<float>& field) {
+    std::vector<SiteOffset> toDirt;
+    std::vector<SiteOffset> toGrass;
+    nearestSites(dirt, 1, w, h, toDirt);
+    nearestSites(dirt, 0, w, h, toGrass);
+    
+    // From a cell centre to the nearest point of the square at offset o
+    auto edgeDistance = [](SiteOffset o) {
+        if (o.dx == NO_SITE) return 999.0f;
+        float ex = std::max(std::abs(o.dx) - 0.5f, 0.0f);
+        float ez = std::max(std::abs(o.dz) - 0.5f, 0.0f);
+        return sqrtf(ex * ex + ez * ez);
     };
+    field.resize((size_t)w * h);
+    for (size_t i = 0; i < field.size(); ++i) {
+        field[i] = dirt[i] ? -edgeDistance(toGrass[i]) : edgeDistance(toDirt[i]);
+    }
+}
+
+void GrassField::planBuild(GrassBuildPlan& plan, GrassInstanceData& out, const GrassTileView& view) {
+    PROFILE_SCOPE("GrassField::planBuild");
+    const tileGrid& tiles = *view.tiles;
+    const int width = view.width;
+    const int height = view.height;
+    const BiomeManager& biomeMan = BiomeManager::getInstance();
     
+    // Settings are copied so every band of this build sees the same values
+    plan.settings = VisualSettings::getInstance().getGrassSettings();
+    const GrassSettings& settings = plan.settings;
+    const TerrainSettings& terrainSettings = VisualSettings::getInstance().getTerrainSettings();
+    plan.tiles.assign((size_t)width * height, GrassTilePlan{});
+    plan.originX = view.originX;
+    plan.originZ = view.originZ;
+    plan.width = width;
+    plan.height = height;
+    
+    // Dirt-like tiles (sand, stone, snow by the biome's top texture) over the
+    // chunk and its border, then their distance field. Grass is only built
+    // well inside the load radius, so the neighbours are normally loaded;
+    // where one is not, the chunk's own edge tile stands in.
+    const int B = GrassTileView::DIRT_BORDER;
+    const int fieldW = width + 2 * B;
+    const int fieldH = height + 2 * B;
+    std::vector<uint8_t> dirt((size_t)fieldW * fieldH);
+    for (int z = 0; z < fieldH; ++z) {
+        for (int x = 0; x < fieldW; ++x) {
+            const tile* t = tiles.borderTile(x - B, z - B);
+            if (!t) t = tiles.borderTile(std::clamp(x - B, 0, width - 1), std::clamp(z - B, 0, height - 1));
+            uint8_t tex = biomeMan.getTopTexture(t->biome);
+            dirt[z * fieldW + x] = tex == SAND || tex == STONE || tex == SNOW;
+        }
+    }
+    buildDirtField(dirt, fieldW, fieldH, plan.dirtField);
+    plan.dirtFieldWidth = fieldW;
+    
+    uint32_t total = 0;
     for (int tz = 0; tz < height; ++tz) {
         for (int tx = 0; tx < width; ++tx) {
-            int tileIdx = idx(tx, tz);
-            BiomeType biomeType = biomes[tileIdx];
-            const BiomeData& biomeData = biomeMan.getBiomeData(biomeType);
+            const tile& src = *tiles.borderTile(tx, tz);
+            GrassTilePlan& tile = plan.tiles[tz * width + tx];
+            tile.first = total;
+            
+            const BiomeData& biomeData = biomeMan.getBiomeData(src.biome);
             
             // Skip if biome doesn't have grass
             if (!biomeData.grass.enabled) continue;
             
-            uint8_t temp = temperatures[tileIdx];
-            uint8_t moist = moistures[tileIdx];
-            uint8_t bio = biologicalPotentials[tileIdx];
-            uint8_t erosionRaw = erosionFactors[tileIdx];
+            uint8_t temp = src.temperature;
             
             // Normalized values
             float tempNorm = temp / 255.0f;
-            float moistNorm = moist / 255.0f;
-            float bioNorm = bio / 255.0f;
+            float moistNorm = src.moisture / 255.0f;
+            float bioNorm = src.biologicalPotential / 255.0f;
             
             // === Use actual erosion data from erosion simulation ===
-            float erosionFactor = erosionRaw / 255.0f;
-            
-            // Get terrain settings for erosion thresholds
-            const TerrainSettings& terrainSettings = VisualSettings::getInstance().getTerrainSettings();
+            float erosionFactor = src.erosionFactor / 255.0f;
             
             // Apply same thresholds as shader
             float blendRange = std::max(0.01f, terrainSettings.erosionFullExpose - terrainSettings.erosionThreshold);
@@ -308,14 +387,11 @@ void GrassField::generate(
             
             // Apply patchiness
             if (biomeData.grass.patchiness > 0.0f) {
-                // Use simplex noise for patches
-                // We don't have simplex noise handy here, so let's use a simple noise function
-                // or just reuse the hash function for a grid-based noise
+                // Simple value noise over a grid of hashed values
                 float scale = std::max(1.0f, biomeData.grass.patchScale);
-                float nx = (chunkWorldX + tx) / scale;
-                float nz = (chunkWorldZ + tz) / scale;
+                float nx = (view.originX + tx) / scale;
+                float nz = (view.originZ + tz) / scale;
                 
-                // Simple value noise
                 int ix = (int)floor(nx);
                 int iz = (int)floor(nz);
                 float fx = nx - ix;
@@ -358,204 +434,211 @@ void GrassField::generate(
             // Skip if too sparse
             if (density < settings.minDensity) continue;
             
-            // === Calculate height multiplier based on biome ===
-            float biomeHeightMult = biomeData.grass.heightMultiplier;
-            
             int bladesToPlace = static_cast<int>(settings.bladesPerTile * density);
             if (bladesToPlace < 1) bladesToPlace = 1;
+            tile.count = static_cast<uint16_t>(bladesToPlace);
+            total += tile.count;
             
-            // Compute base grass color from biome data
-            // We use the biome's configured colors instead of the global settings
-            // but we still apply some variation based on temp/moist
-            Vector3 tipColor = biomeData.grass.tipColor;
-            Vector3 baseColor = biomeData.grass.baseColor;
+            // Height multiplier from biome and erosion; base height and
+            // per-blade variation are applied in the shader
+            tile.heightMult = biomeData.grass.heightMultiplier * erosionMult;
+            tile.leanAmount = 0.1f + erosionFactor * 0.25f;
+            tile.temperature = tempNorm;
             
-            // Apply subtle variation
-            tipColor.x += (tempNorm - 0.5f) * 0.1f; // Temp affects red
-            tipColor.y += (moistNorm - 0.5f) * 0.1f; // Moist affects green
+            // Biome tip colour with subtle variation
+            tile.color = biomeData.grass.tipColor;
+            tile.color.x += (tempNorm - 0.5f) * 0.1f; // Temp affects red
+            tile.color.y += (moistNorm - 0.5f) * 0.1f; // Moist affects green
             
-            // Place blades within this tile
-            for (int b = 0; b < bladesToPlace; ++b) {
-                // Deterministic pseudo-random position within tile
-                uint32_t seed = hash(chunkWorldX + tx + (chunkWorldZ + tz) * 65537 + b * 31337);
-                
-                float localX = tx + hashFloat(seed);
-                float localZ = tz + hashFloat(seed + 1);
-                float worldX = chunkWorldX + localX;
-                float worldZ = chunkWorldZ + localZ;
-                
-                // Calculate dirt blending for this blade position
-                float dirtDist = distToDirt(tx, tz, localX, localZ);
-                float dirtBlend = 0.0f;
-                if (dirtDist < settings.dirtBlendDistance) {
-                    // Smoothstep falloff for natural transition
-                    float t = dirtDist / settings.dirtBlendDistance;
-                    t = t * t * (3.0f - 2.0f * t);  // Smoothstep
-                    dirtBlend = (1.0f - t) * settings.dirtBlendStrength;
+            // Bilinear height surface of the tile from its own corners
+            // ([0]=TL, [1]=TR, [2]=BR, [3]=BL), so blades follow the tile even
+            // where it steps away from its neighbours:
+            // h(fx, fz) = h00 + dhdx * fx + dhdz * fz + twist * fx * fz
+            float h00 = src.tileHeight[0];
+            float h10 = src.tileHeight[1];
+            float h11 = src.tileHeight[2];
+            float h01 = src.tileHeight[3];
+            tile.h00 = h00;
+            tile.dhdx = h10 - h00;
+            tile.dhdz = h01 - h00;
+            tile.twist = h00 - h10 - h01 + h11;
+            tile.dirtDistance = plan.dirtField[(tz + B) * fieldW + tx + B];
+        }
+    }
+    
+    // Preallocated output: every tile writes its own range, so row bands
+    // can be placed concurrently
+    plan.bladeCount = total;
+    plan.ranks.assign(total, 0.0f);
+    out.instances.resize(total);
+    out.originX = view.originX;
+    out.originZ = view.originZ;
+}
+
+void GrassField::placeRows(GrassBuildPlan& plan, GrassInstanceData& out, int rowBegin, int rowEnd) {
+    PROFILE_SCOPE("GrassField::placeRows");
+    const int width = plan.width;
+    const Vector3 lightDir = Vector3Normalize({-0.59f, 1.0f, 0.8f});  // Negated = toward sun
+    const int B = GrassTileView::DIRT_BORDER;
+    const int fieldW = plan.dirtFieldWidth;
+    
+    // Blades are processed in fixed-size batches of plain arrays; every loop
+    // below is branch-free over the batch so the compiler can vectorize it
+    constexpr int BATCH = 8;
+    uint32_t seed[BATCH];
+    float fx[BATCH], fz[BATCH], heightJitter[BATCH], lean[BATCH], stiffness[BATCH], jitter[BATCH];
+    float y[BATCH], diffuse[BATCH], dirtDist[BATCH];
+    
+    for (int tz = rowBegin; tz < rowEnd; ++tz) {
+        for (int tx = 0; tx < width; ++tx) {
+            const GrassTilePlan& tile = plan.tiles[tz * width + tx];
+            if (tile.count == 0) continue;
+            
+            // Dirt field at the 3x3 tile centres around this one. The field
+            // changes by at most about a tile per tile, so blades of a tile
+            // far enough from dirt skip sampling it.
+            bool nearDirt = tile.dirtDistance - 1.0f < PackedGrassInstance::MAX_DIRT_DISTANCE;
+            float field[3][3];
+            for (int dz = 0; dz < 3; ++dz) {
+                for (int dx = 0; dx < 3; ++dx) {
+                    field[dz][dx] = plan.dirtField[(tz + B + dz - 1) * fieldW + tx + B + dx - 1];
                 }
+            }
+            
+            uint32_t tileSeed = plan.originX + tx + (plan.originZ + tz) * 65537;
+            for (int b0 = 0; b0 < tile.count; b0 += BATCH) {
+                int n = std::min(BATCH, (int)tile.count - b0);
                 
-                // Color for this blade
-                float r = tipColor.x;
-                float g = tipColor.y;
-                float blueVal = tipColor.z;
+                // Deterministic pseudo-random values per blade
+                for (int i = 0; i < BATCH; ++i) seed[i] = hash(tileSeed + (b0 + i) * 31337);
+                for (int i = 0; i < BATCH; ++i) fx[i] = hashFloat(seed[i]);
+                for (int i = 0; i < BATCH; ++i) fz[i] = hashFloat(seed[i] + 1);
+                for (int i = 0; i < BATCH; ++i) heightJitter[i] = hashFloat(seed[i] + 3);
+                for (int i = 0; i < BATCH; ++i) lean[i] = (hashFloat(seed[i] + 4) - 0.5f) * tile.leanAmount * 2.0f;
+                for (int i = 0; i < BATCH; ++i) stiffness[i] = 0.3f + hashFloat(seed[i] + 5) * 0.5f;
+                for (int i = 0; i < BATCH; ++i) jitter[i] = hashFloat(seed[i] + 6);
                 
-                if (dirtBlend > 0.0f) {
-                    r = r * (1.0f - dirtBlend) + settings.dirtBlendColor.x * dirtBlend;
-                    g = g * (1.0f - dirtBlend) + settings.dirtBlendColor.y * dirtBlend;
-                    blueVal = blueVal * (1.0f - dirtBlend) + settings.dirtBlendColor.z * dirtBlend;
+                // Height and terrain normal from the tile's bilinear surface
+                for (int i = 0; i < BATCH; ++i) {
+                    y[i] = tile.h00 + tile.dhdx * fx[i] + tile.dhdz * fz[i] + tile.twist * fx[i] * fz[i];
+                }
+                for (int i = 0; i < BATCH; ++i) {
+                    float nx = -(tile.dhdx + tile.twist * fz[i]);
+                    float nz = -(tile.dhdz + tile.twist * fx[i]);
+                    float invLen = 1.0f / sqrtf(nx * nx + 1.0f + nz * nz);
+                    diffuse[i] = std::max(0.0f, (nx * lightDir.x + lightDir.y + nz * lightDir.z) * invLen);
                 }
                 
-                // Get height at this position
-                float y = getHeightAt(localX, localZ, tx, tz, width, tileHeights);
-                
-                // Random rotation around Y axis
-                float rotation = hashFloat(seed + 2) * 2.0f * PI;
-                
-                // Height variation from settings, apply biome multiplier
-                float heightVar = settings.heightVariation;
-                float baseHeightVar = (1.0f - heightVar/2.0f) + hashFloat(seed + 3) * heightVar;
-                float heightScale = baseHeightVar * biomeHeightMult * erosionMult * (settings.baseHeight / BLADE_BASE_HEIGHT);
-                
-                // Base angle (slight lean)
-                float leanAmount = 0.1f + erosionFactor * 0.25f;
-                float baseAngle = (hashFloat(seed + 4) - 0.5f) * leanAmount * 2.0f;
-                
-                // Stiffness variation
-                float stiffness = 0.3f + hashFloat(seed + 5) * 0.5f;
-                
-                // Compute terrain normal at this position (from height gradient)
-                float eps = 0.1f;
-                float hL = getHeightAt(std::max(0.0f, localX - eps), localZ, tx, tz, width, tileHeights);
-                float hR = getHeightAt(std::min((float)width, localX + eps), localZ, tx, tz, width, tileHeights);
-                float hD = getHeightAt(localX, std::max(0.0f, localZ - eps), tx, tz, width, tileHeights);
-                float hU = getHeightAt(localX, std::min((float)height, localZ + eps), tx, tz, width, tileHeights);
-                
-                Vector3 terrainNormal = Vector3Normalize({
-                    (hL - hR) / (2.0f * eps),
-                    1.0f,
-                    (hD - hU) / (2.0f * eps)
-                });
-                
-                // Compute diffuse lighting on CPU
-                Vector3 lightDir = Vector3Normalize({-0.59f, 1.0f, 0.8f});  // Negated = toward sun
-                float diffuse = std::max(0.0f, Vector3DotProduct(terrainNormal, lightDir));
-                
-                // Build transform matrix (for billboard, we mainly need position)
-                Matrix scale = MatrixScale(1.0f, heightScale, 1.0f);
-                Matrix translate = MatrixTranslate(worldX, y, worldZ);
-                Matrix transform = MatrixMultiply(scale, translate);
-                
-                transforms.push_back(transform);
-                
-                // Store blade data with pre-computed diffuse (using blended colors)
-                GrassBlade blade;
-                blade.r = r;
-                blade.g = g;
-                blade.b = blueVal;
-                blade.diffuse = diffuse;
-                blade.temperature = temp / 255.0f;  // Normalized temperature for shader
-                blade.heightScale = heightScale;
-                blade.baseAngle = baseAngle;
-                blade.stiffness = stiffness;
+                // Distance to the nearest dirt-like tile edge, bilinear between
+                // the two tile centres on either side of the blade on each axis
+                for (int i = 0; i < BATCH; ++i) dirtDist[i] = 999.0f;
+                if (nearDirt) {
+                    for (int i = 0; i < BATCH; ++i) {
+                        int ix = fx[i] >= 0.5f;
+                        int iz = fz[i] >= 0.5f;
+                        float wx = fx[i] + 0.5f - ix;
+                        float wz = fz[i] + 0.5f - iz;
+                        float top = lerpf(field[iz][ix], field[iz][ix + 1], wx);
+                        float bottom = lerpf(field[iz + 1][ix], field[iz + 1][ix + 1], wx);
+                        // Blades on dirt-like tiles are at distance 0
+                        dirtDist[i] = std::max(0.0f, lerpf(top, bottom, wz));
+                    }
+                }
                 
-                bladeData.push_back(blade);
+                for (int i = 0; i < n; ++i) {
+                    int b = b0 + i;
+                    
+                    // Positions stay chunk-local; the shader adds the chunk
+                    // origin and blends toward dirt by the stored distance
+                    uint32_t slot = tile.first + b;
+                    out.instances[slot] = PackedGrassInstance::pack(
+                        tx + fx[i], y[i], tz + fz[i], tile.heightMult, heightJitter[i], tile.color,
+                        diffuse[i], tile.temperature, lean[i], stiffness[i],
+                        std::min(dirtDist[i], PackedGrassInstance::MAX_DIRT_DISTANCE));
+                    plan.ranks[slot] = (b + jitter[i]) / tile.count;
+                }
             }
         }
     }
-    
-    bladeCount = transforms.size();
-    
-    if (bladeCount > 0) {
-        uploadInstanceData();
-    }
 }
 
-void GrassField::uploadInstanceData() {
+void GrassField::finishBuild(GrassBuildPlan& plan, GrassInstanceData& out) {
+    PROFILE_SCOPE("GrassField::finishBuild");
+    // Stratified order: blade b of a tile's n ranks in [b/n, (b+1)/n), so
+    // any prefix of the buffer holds about the same fraction of every tile's
+    // blades. Drawing fewer instances then thins the whole chunk evenly.
+    std::vector<uint32_t> order(out.instances.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return plan.ranks[a] < plan.ranks[b]; });
+    std::vector<PackedGrassInstance> sorted;
+    sorted.reserve(order.size());
+    for (uint32_t i : order) sorted.push_back(out.instances[i]);
+    out.instances.swap(sorted);
+}
+
+void GrassField::upload(const GrassInstanceData& data) {
+    generateBladeMesh();
+    
+    bladeCount = data.bladeCount();
+    originX = static_cast<float>(data.originX);
+    originZ = static_cast<float>(data.originZ);
     if (bladeCount == 0 || vaoId == 0) return;
     
-    // Convert Matrix array to float16 array (raylib's MatrixToFloatV format)
-    std::vector<float> instanceData(bladeCount * 16);
-    for (size_t i = 0; i < bladeCount; ++i) {
-        float16 m = MatrixToFloatV(transforms[i]);
-        memcpy(&instanceData[i * 16], m.v, 16 * sizeof(float));
-    }
+    int bytes = (int)(bladeCount * sizeof(PackedGrassInstance));
     
-    // Build per-instance color+diffuse data (vec4 per blade: RGB + diffuse)
-    std::vector<float> colorData(bladeCount * 4);
-    for (size_t i = 0; i < bladeCount; ++i) {
-        colorData[i * 4 + 0] = bladeData[i].r;
-        colorData[i * 4 + 1] = bladeData[i].g;
-        colorData[i * 4 + 2] = bladeData[i].b;
-        colorData[i * 4 + 3] = bladeData[i].diffuse;
+    // Refill the existing instance buffer when the new blades fit
+    if (vboInstances != 0 && bladeCount <= instanceCapacity) {
+        rlUpdateVertexBuffer(vboInstances, data.instances.data(), bytes, 0);
+        rlDisableVertexBuffer();
+        PROFILE_COUNT("gl buffer refills", 1);
+        return;
     }
     
-    // Bind our VAO to add the instance buffers
-    rlEnableVertexArray(vaoId);
-    
     // Clean up old instance buffers if they exist
-    if (vboInstanceTransforms != 0) {
-        rlUnloadVertexBuffer(vboInstanceTransforms);
-    }
-    if (vboInstanceColors != 0) {
-        rlUnloadVertexBuffer(vboInstanceColors);
-    }
+    clear();
+    bladeCount = data.bladeCount();
+    
+    // Headroom so a recycled chunk with a little more grass still fits
+    instanceCapacity = bladeCount + bladeCount / 4;
     
-    // Create instance transform VBO
-    vboInstanceTransforms = rlLoadVertexBuffer(instanceData.data(), 
-                                                instanceData.size() * sizeof(float), 
-                                                false);
+    // Bind our VAO to add the instance buffer
+    rlEnableVertexArray(vaoId);
+    
+    // One interleaved instance VBO (dynamic, since later uploads refill it)
+    vboInstances = rlLoadVertexBuffer(nullptr, (int)(instanceCapacity * sizeof(PackedGrassInstance)), true);
+    rlUpdateVertexBuffer(vboInstances, data.instances.data(), bytes, 0);
     
     // IMPORTANT: Enable the VBO we just created before setting its attributes
-    rlEnableVertexBuffer(vboInstanceTransforms);
-    
-    // A mat4 takes up 4 consecutive attribute slots (each slot is vec4)
-    // We use locations 3, 4, 5, 6 for instanceTransform (after pos=0, uv=1, normal=2)
-    for (int i = 0; i < 4; i++) {
-        int attribLoc = 3 + i;
-        rlEnableVertexAttribute(attribLoc);
-        rlSetVertexAttribute(attribLoc, 4, RL_FLOAT, false, sizeof(Matrix), i * sizeof(Vector4));
-        rlSetVertexAttributeDivisor(attribLoc, 1);  // 1 = advance once per instance
-    }
+    rlEnableVertexBuffer(vboInstances);
+    const int stride = sizeof(PackedGrassInstance);
     
-    // Create instance color+diffuse VBO at location 7 (vec4: rgb + diffuse)
-    vboInstanceColors = rlLoadVertexBuffer(colorData.data(),
-                                            colorData.size() * sizeof(float),
-                                            false);
-    rlEnableVertexBuffer(vboInstanceColors);
-    rlEnableVertexAttribute(7);
-    rlSetVertexAttribute(7, 4, RL_FLOAT, false, 0, 0);  // vec4, no stride, no offset
-    rlSetVertexAttributeDivisor(7, 1);  // 1 = advance once per instance
-    
-    // Build per-instance temperature data (float per blade)
-    std::vector<float> tempData(bladeCount);
-    for (size_t i = 0; i < bladeCount; ++i) {
-        tempData[i] = bladeData[i].temperature;
-    }
+    // Location 3: position + RGB565 colour as raw integers (after pos=0, uv=1, normal=2)
+    rlEnableVertexAttribute(3);
+    rlSetVertexAttribute(3, 4, RL_UNSIGNED_SHORT, false, stride, offsetof(PackedGrassInstance, position));
+    rlSetVertexAttributeDivisor(3, 1);  // 1 = advance once per instance
     
-    // Clean up old temp buffer if exists
-    if (vboInstanceTemp != 0) {
-        rlUnloadVertexBuffer(vboInstanceTemp);
-    }
+    // Location 4: height scale, diffuse, temperature, lean (unorm8)
+    rlEnableVertexAttribute(4);
+    rlSetVertexAttribute(4, 4, RL_UNSIGNED_BYTE, true, stride, offsetof(PackedGrassInstance, heightScale));
+    rlSetVertexAttributeDivisor(4, 1);
     
-    // Create instance temperature VBO at location 8 (float)
-    vboInstanceTemp = rlLoadVertexBuffer(tempData.data(),
-                                          tempData.size() * sizeof(float),
-                                          false);
-    rlEnableVertexBuffer(vboInstanceTemp);
-    rlEnableVertexAttribute(8);
-    rlSetVertexAttribute(8, 1, RL_FLOAT, false, 0, 0);  // single float, no stride, no offset
-    rlSetVertexAttributeDivisor(8, 1);  // 1 = advance once per instance
+    // Location 5: stiffness, height jitter, dirt distance, unused (unorm8)
+    rlEnableVertexAttribute(5);
+    rlSetVertexAttribute(5, 4, RL_UNSIGNED_BYTE, true, stride, offsetof(PackedGrassInstance, stiffness));
+    rlSetVertexAttributeDivisor(5, 1);
     
     rlDisableVertexBuffer();
     rlDisableVertexArray();
+    PROFILE_COUNT("gl objects created", 1);
     
     resourcesLoaded = true;
-    TraceLog(LOG_INFO, "GRASS: Instance data uploaded - %zu instances, transform VBO: %u, color VBO: %u, temp VBO: %u", 
-             bladeCount, vboInstanceTransforms, vboInstanceColors, vboInstanceTemp);
+    TraceLog(LOG_INFO, "GRASS: Instance data uploaded - %zu instances, instance VBO: %u", bladeCount, vboInstances);
 }
 
-void GrassField::render(float time) {
+void GrassField::render(float time, float density) {
     if (!meshGenerated || bladeCount == 0 || vaoId == 0) return;
+    size_t instances = std::min(bladeCount, (size_t)std::ceil(bladeCount * std::clamp(density, 0.0f, 1.0f)));
+    if (instances == 0) return;
     
     // Get the grass shader
     Shader& shader = resourceManager::getGrassShader();
@@ -581,12 +664,23 @@ void GrassField::render(float time) {
         rlSetUniform(locs.time, &time, SHADER_UNIFORM_FLOAT, 1);
     }
     
+    // Instance positions are relative to the chunk origin
+    if (locs.chunkOrigin != -1) {
+        float origin[2] = {originX, originZ};
+        rlSetUniform(locs.chunkOrigin, origin, SHADER_UNIFORM_VEC2, 1);
+    }
+    // Full count, so each blade knows its rank in the stratified order
+    if (locs.bladeCount != -1) {
+        float total = static_cast<float>(bladeCount);
+        rlSetUniform(locs.bladeCount, &total, SHADER_UNIFORM_FLOAT, 1);
+    }
+    
     // Disable backface culling for grass (visible from both sides)
     rlDisableBackfaceCulling();
     
     // Bind our VAO and draw instanced
     if (rlEnableVertexArray(vaoId)) {
-        rlDrawVertexArrayInstanced(0, vertexCount, static_cast<int>(bladeCount));
+        rlDrawVertexArrayInstanced(0, vertexCount, static_cast<int>(instances));
     }
     
     rlDisableVertexArray();
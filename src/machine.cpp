@@ -80,34 +80,9 @@ drillMk1::drillMk1(Vector3 position)
 
 drillMk1::~drillMk1() {}
 
-void drillMk1::update(machineManager& manager) {
-    const float PRODUCTION_TIME = 2.0f; // seconds to produce 1 ore
-    productionProgress += GetFrameTime();
-
-    if (productionProgress >= PRODUCTION_TIME) {
-        productionProgress -= PRODUCTION_TIME;
-        
-        // This initialization now works because item is an aggregate type
-        item newOre = {IRON_ORE, 1};
-        
-        // Try to give the item to the machine in front of the drill
-        // Use the standard forward direction (0, -1) and rotate it based on drill direction
-        machineTileOffset forwardOffset = {0, -1};
-        machineTileOffset rotatedOffset = forwardOffset.getRotatedOffset(dir);
-        globalMachinePos nextPos = {globalPos.x + rotatedOffset.x, globalPos.y + rotatedOffset.y};
-        
-        machine* nextMachine = manager.getMachineAt(nextPos);
-        if (nextMachine != nullptr) {
-            // Try to give the item to the next machine
-            if (!nextMachine->giveItem(newOre, manager)) {
-                // If the next machine couldn't accept the item, add it to our own inventory
-                inventory.tryAddItem(newOre);
-            }
-        } else {
-            // No machine in front, add to our own inventory
-            inventory.tryAddItem(newOre);
-        }
-    }
+Inventory* drillMk1::getInventory() {
+    if (owner) inventory.setSlotItem(0, {IRON_ORE, owner->getDrills().output[slot]});
+    return &inventory;
 }
 
 void drillMk1::render() {
@@ -136,64 +111,12 @@ conveyorMk1::conveyorMk1(Vector3 position)
       inventory({ InventorySlot{slotInterfaceTile{-1,0}, STORAGE, std::nullopt, 1, {IRON_ORE, 0}} }) // one storage slot, capacity 1
 {}
 
-bool conveyorMk1::giveItem(item anItem, machineManager& manager) {
-    // First check if we can accept the item (have space)
-    // We need to check if our inventory slot is empty since we only have one slot with capacity 1
-    const std::vector<InventorySlot>& slots = inventory.getSlots();
-    const InventorySlot& slot = slots[0];
-    if (slot.currentItem.quantity == 0) {
-        // Reset processing time to create cooldown
-        processingProgress = 0.0f;
-        movementProgress = 0.0f; // Reset movement progress
-        // Store the item temporarily
-        heldItem = anItem;
-        hasHeldItem = true;
-        hasItemToRender = true; // Mark that we should render an item
-        return true;
-    }
-    return false; // Could not accept item (slot is occupied)
-}
-
-void conveyorMk1::update(machineManager& manager) {
-    // If we have a held item, process it
-    if (hasHeldItem) {
-        // If this is the first update cycle for this item, add it to our inventory
-        const std::vector<InventorySlot>& slots = inventory.getSlots();
-        if (slots[0].currentItem.quantity == 0) {
-            inventory.tryAddItem(heldItem);
-        }
-        
-        processingProgress += GetFrameTime();
-        movementProgress += GetFrameTime() / PROCESSING_TIME; // Update movement progress
-        
-        // Check if processing is complete
-        if (processingProgress >= PROCESSING_TIME) {
-            // Try to pass the item to the next machine in the chain
-            // Use the standard forward direction (0, -1) and rotate it based on conveyor direction
-            machineTileOffset forwardOffset = {0, -1};
-            machineTileOffset rotatedOffset = forwardOffset.getRotatedOffset(dir);
-            globalMachinePos nextPos = {globalPos.x + rotatedOffset.x, globalPos.y + rotatedOffset.y};
-            
-            machine* nextMachine = manager.getMachineAt(nextPos);
-            if (nextMachine != nullptr) {
-                // Try to give the item to the next machine
-                if (nextMachine->giveItem(heldItem, manager)) {
-                    // Successfully passed the item, clear our held item and remove from inventory
-                    hasHeldItem = false;
-                    processingProgress = 0.0f;
-                    movementProgress = 0.0f; // Reset movement progress
-                    hasItemToRender = false; // No longer need to render the item
-                    // Remove the item from our inventory
-                    item takenItem;
-                    inventory.tryTakeItem(takenItem, static_cast<itemType>(heldItem.type));
-                }
-                // If next machine couldn't accept, we keep the item and will try again next update
-            } else {
-                // No machine in front, keep the item in our inventory
-                // It will be rendered but not moved until a machine is placed
-            }
-        }
+Inventory* conveyorMk1::getInventory() {
+    if (owner) {
+        const ConveyorStore& conveyors = owner->getConveyors();
+        inventory.setSlotItem(0, {conveyors.items[slot], conveyors.full[slot]});
     }
+    return &inventory;
 }
 
 void conveyorMk1::render() {
@@ -211,17 +134,11 @@ void conveyorMk1::render() {
                 {0, 1, 0}, rotationAngle, Vector3{0.5f, 0.5f, 0.5f}, WHITE);
 
     // Render item on conveyor if present
-    Inventory* inv = getInventory();
-    if ((inv && inv->getSlots()[0].currentItem.quantity > 0) || hasItemToRender) {
-        item currentItem;
-        if (inv && inv->getSlots()[0].currentItem.quantity > 0) {
-            currentItem = inv->getSlots()[0].currentItem;
-        } else {
-            currentItem = heldItem;
-        }
-        
-        Texture2D texture = resourceManager::getItemTexture(static_cast<itemType>(currentItem.type));
-        Rectangle sourceRect = resourceManager::getItemTextureUV(static_cast<itemType>(currentItem.type));
+    const ConveyorStore& conveyors = owner->getConveyors();
+    if (conveyors.full[slot]) {
+        itemType heldType = static_cast<itemType>(conveyors.items[slot]);
+        Texture2D texture = resourceManager::getItemTexture(heldType);
+        Rectangle sourceRect = resourceManager::getItemTextureUV(heldType);
         
         // Calculate start and end positions based on conveyor direction
         Vector3 startPos = {0, 0, 0}, endPos = {0, 0, 0};
@@ -245,7 +162,7 @@ void conveyorMk1::render() {
         }
         
         // Lerp between start and end positions based on movement progress
-        float t = fminf(movementProgress, 1.0f); // Clamp to 1.0
+        float t = fminf(conveyors.progress[slot] / ConveyorStore::PROCESSING_TIME, 1.0f); // Clamp to 1.0
         Vector3 itemPos = {
             startPos.x + t * (endPos.x - startPos.x),
             startPos.y + t * (endPos.y - startPos.y),
@@ -267,7 +184,6 @@ droppedItem::droppedItem(Vector3 position, itemType type) : machine(ITEM, positi
     itemInstance.quantity = 1;
 }
 droppedItem::~droppedItem() {}
-void droppedItem::update(machineManager& manager) {}
 void droppedItem::render() {
     Texture2D texture = resourceManager::getItemTexture(static_cast<itemType>(itemInstance.type));
     Rectangle sourceRect = resourceManager::getItemTextureUV(static_cast<itemType>(itemInstance.type));
@@ -276,3 +192,91 @@ void droppedItem::render() {
     // Render slots for debugging (won't show anything since dropped items don't have slots)
     renderSlots();
 }
+
+// --- Machine stores --- //
+
+uint32_t ConveyorStore::add(machine* handle) {
+    handles.push_back(handle);
+    progress.push_back(0.0f);
+    items.push_back(IRON_ORE);
+    full.push_back(0);
+    target.push_back(-1);
+    return (uint32_t)(handles.size() - 1);
+}
+
+machine* ConveyorStore::remove(uint32_t slot) {
+    size_t last = handles.size() - 1;
+    machine* moved = nullptr;
+    if (slot != last) {
+        handles[slot] = handles[last];
+        progress[slot] = progress[last];
+        items[slot] = items[last];
+        full[slot] = full[last];
+        target[slot] = target[last];
+        moved = handles[slot];
+    }
+    handles.pop_back();
+    progress.pop_back();
+    items.pop_back();
+    full.pop_back();
+    target.pop_back();
+    return moved;
+}
+
+bool ConveyorStore::accept(uint32_t slot, uint16_t type) {
+    if (full[slot]) return false;
+    full[slot] = 1;
+    items[slot] = type;
+    progress[slot] = 0.0f;  // Cooldown and movement restart with the new item
+    return true;
+}
+
+void ConveyorStore::update(float dt) {
+    const size_t n = size();
+    for (size_t i = 0; i < n; ++i) progress[i] += full[i] ? dt : 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        if (!full[i] || progress[i] < PROCESSING_TIME || target[i] < 0) continue;
+        // A blocked item waits at the end until the conveyor in front has room
+        if (accept(target[i], items[i])) {
+            full[i] = 0;
+            progress[i] = 0.0f;
+        }
+    }
+}
+
+uint32_t DrillStore::add(machine* handle) {
+    handles.push_back(handle);
+    progress.push_back(0.0f);
+    output.push_back(0);
+    target.push_back(-1);
+    return (uint32_t)(handles.size() - 1);
+}
+
+machine* DrillStore::remove(uint32_t slot) {
+    size_t last = handles.size() - 1;
+    machine* moved = nullptr;
+    if (slot != last) {
+        handles[slot] = handles[last];
+        progress[slot] = progress[last];
+        output[slot] = output[last];
+        target[slot] = target[last];
+        moved = handles[slot];
+    }
+    handles.pop_back();
+    progress.pop_back();
+    output.pop_back();
+    target.pop_back();
+    return moved;
+}
+
+void DrillStore::update(float dt, ConveyorStore& conveyors) {
+    const size_t n = size();
+    for (size_t i = 0; i < n; ++i) progress[i] += dt;
+    for (size_t i = 0; i < n; ++i) {
+        if (progress[i] < PRODUCTION_TIME) continue;
+        progress[i] -= PRODUCTION_TIME;
+        // Hand the ore to the conveyor in front, or keep it while there is room
+        if (target[i] >= 0 && conveyors.accept(target[i], IRON_ORE)) continue;
+        if (output[i] < OUTPUT_CAPACITY) output[i]++;
+    }
+}
@@ -1,4 +1,5 @@
 #include "../include/machineManager.hpp"
+#include "../include/profiling.hpp"
 #include <algorithm>
 
 machineManager::machineManager() {}
@@ -9,6 +10,13 @@ void machineManager::addMachine(std::unique_ptr<machine> machine) {
     // Note: Assumes machine->globalPos has been set before adding.
     // The chunkManager should be responsible for setting this.
     machineGrid[machine->globalPos] = machine.get();
+    machine->owner = this;
+    switch (machine->type) {
+        case DRILLMK1: machine->slot = drills.add(machine.get()); break;
+        case CONVEYORMK1: machine->slot = conveyors.add(machine.get()); break;
+        default: break;  // Dropped items have no state to update
+    }
+    linksDirty = true;
     machines.push_back(std::move(machine));
 }
 
@@ -49,6 +57,7 @@ void machineManager::removeMachineAt(globalMachinePos pos) {
 
     // --- Remove from manager ---
     machineGrid.erase(it);
+    releaseSlot(machineToRemove);
 
     machines.erase(
         std::remove_if(machines.begin(), machines.end(),
@@ -58,16 +67,54 @@ void machineManager::removeMachineAt(globalMachinePos pos) {
         machines.end());
 }
 
-void machineManager::update() {
-    // By passing "*this", each machine's update method gets a reference
-    // to the manager, allowing it to query for other machines.
-    for (auto& machine : machines) {
-        machine->update(*this);
+void machineManager::releaseSlot(machine* m) {
+    machine* moved = nullptr;
+    switch (m->type) {
+        case DRILLMK1: moved = drills.remove(m->slot); break;
+        case CONVEYORMK1: moved = conveyors.remove(m->slot); break;
+        default: return;
     }
+    if (moved) moved->slot = m->slot;
+    linksDirty = true;
+}
+
+// Point every drill and conveyor at the conveyor in front of it, if any.
+// Only placement changes this, so the per-frame loops skip the grid lookups.
+void machineManager::relink() {
+    auto forward = [this](const machine* m) -> int32_t {
+        machineTileOffset rotatedOffset = machineTileOffset{0, -1}.getRotatedOffset(m->dir);
+        machine* next = getMachineAt({m->globalPos.x + rotatedOffset.x, m->globalPos.y + rotatedOffset.y});
+        return next && next->type == CONVEYORMK1 ? (int32_t)next->slot : -1;
+    };
+    for (size_t i = 0; i < drills.size(); ++i) drills.target[i] = forward(drills.handles[i]);
+    for (size_t i = 0; i < conveyors.size(); ++i) conveyors.target[i] = forward(conveyors.handles[i]);
+    linksDirty = false;
+}
+
+void machineManager::update() {
+    PROFILE_SCOPE("machineManager::update");
+    if (linksDirty) relink();
+    // Drills feed conveyors, so they run first
+    float dt = GetFrameTime();
+    drills.update(dt, conveyors);
+    conveyors.update(dt);
+    PROFILE_SET("machines updated", (int64_t)(drills.size() + conveyors.size()));
 }
 
 void machineManager::render() {
+    int culled = 0;
     for (auto& machine : machines) {
+        if (world) {
+            // Models are about one tile and sit on its corner
+            const Vector3& p = machine->position;
+            BoundingBox bounds = {{p.x - 0.5f, p.y - 0.5f, p.z - 0.5f}, {p.x + 1.5f, p.y + 2.0f, p.z + 1.5f}};
+            if (!world->isVisible(bounds)) {
+                culled++;
+                continue;
+            }
+        }
         machine->render();
     }
+    PROFILE_SET("machines drawn", (int64_t)(machines.size() - culled));
+    PROFILE_SET("machines culled", culled);
 }
@@ -0,0 +1,79 @@
+#include "../include/meshUploadQueue.hpp"
+#include "../include/profiling.hpp"
+#include <algorithm>
+#include <chrono>
+
+void MeshUploadQueue::push(const void* owner, size_t bytes, std::function<void()> upload) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back({owner, bytes, std::move(upload)});
+    pendingBytes += bytes;
+}
+
+void MeshUploadQueue::cancel(const void* owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto removed = std::remove_if(jobs.begin(), jobs.end(), [owner](const Job& job) {
+        return job.owner == owner;
+    });
+    for (auto it = removed; it != jobs.end(); ++it) pendingBytes -= it->bytes;
+    jobs.erase(removed, jobs.end());
+}
+
+void MeshUploadQueue::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.clear();
+    pendingBytes = 0;
+}
+
+void MeshUploadQueue::drain() {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    Budget frameBudget = getBudget();
+    size_t uploadedBytes = 0;
+    int uploads = 0;
+
+    while (true) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (jobs.empty()) break;
+            // Always make progress, but never start a job that would overrun the byte budget
+            if (uploads > 0 && uploadedBytes + jobs.front().bytes > frameBudget.maxBytes) break;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            pendingBytes -= job.bytes;
+        }
+
+        // Run outside the lock; uploads may queue follow-up work
+        job.upload();
+        uploadedBytes += job.bytes;
+        uploads++;
+
+        std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+        if (elapsed.count() >= frameBudget.maxMs) break;
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+    PROFILE_VALUE("upload queue ms/frame", elapsed.count());
+    PROFILE_SET("upload queue bytes/frame", (int64_t)uploadedBytes);
+    PROFILE_SET("upload queue pending", (int64_t)getPendingCount());
+}
+
+void MeshUploadQueue::setBudget(const Budget& newBudget) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = newBudget;
+}
+
+MeshUploadQueue::Budget MeshUploadQueue::getBudget() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budget;
+}
+
+size_t MeshUploadQueue::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
+
+size_t MeshUploadQueue::getPendingBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pendingBytes;
+}
@@ -0,0 +1,106 @@
+#include "../include/profiling.hpp"
+#include "../libs/rlImGui/imgui/imgui.h"
+#include <algorithm>
+
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+// Entry for name, only building a key string the first time
+template <typename Map>
+static typename Map::mapped_type& entry(Map& map, const char* name) {
+    auto it = map.find(name);
+    if (it == map.end()) it = map.emplace(name, typename Map::mapped_type{}).first;
+    return it->second;
+}
+
+void Profiler::recordTime(const char* name, double ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ProfileTimer& t = entry(timers, name);
+    t.lastMs = ms;
+    // Smooth over roughly the last 30 samples
+    t.avgMs = (t.calls == 0) ? ms : t.avgMs + (ms - t.avgMs) * (1.0 / 30.0);
+    t.maxMs = std::max(t.maxMs, ms);
+    t.calls++;
+}
+
+void Profiler::addCount(const char* name, int64_t delta) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entry(counters, name) += delta;
+}
+
+void Profiler::setCount(const char* name, int64_t value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entry(counters, name) = value;
+}
+
+void Profiler::setValue(const char* name, double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entry(values, name) = value;
+}
+
+int64_t Profiler::getCount(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = counters.find(name);
+    return it != counters.end() ? it->second : 0;
+}
+
+double Profiler::getValue(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = values.find(name);
+    return it != values.end() ? it->second : 0.0;
+}
+
+ProfileTimer Profiler::getTimer(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = timers.find(name);
+    return it != timers.end() ? it->second : ProfileTimer{};
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    timers.clear();
+    counters.clear();
+    values.clear();
+}
+
+void Profiler::renderUI(bool* open) {
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    bool doReset = ImGui::Button("Reset");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (ImGui::CollapsingHeader("Timers (ms)")) {
+            for (const auto& entry : timers) {
+                const ProfileTimer& t = entry.second;
+                ImGui::Text("%-36s last %8.3f  avg %8.3f  max %8.3f  n=%llu",
+                            entry.first.c_str(), t.lastMs, t.avgMs, t.maxMs,
+                            static_cast<unsigned long long>(t.calls));
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Counters")) {
+            for (const auto& entry : counters) {
+                ImGui::Text("%-36s %lld", entry.first.c_str(), static_cast<long long>(entry.second));
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Values")) {
+            for (const auto& entry : values) {
+                ImGui::Text("%-36s %.3f", entry.first.c_str(), entry.second);
+            }
+        }
+    }
+
+    ImGui::End();
+
+    if (doReset) {
+        reset();
+    }
+}
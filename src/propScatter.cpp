@@ -0,0 +1,463 @@
+#include "../include/propScatter.hpp"
+#include "../include/meshData.hpp"
+#include "../include/tileGrid.hpp"
+#include "../include/biome.hpp"
+#include "../include/resourceManager.hpp"
+#include "../include/profiling.hpp"
+#include "../include/scratchArena.hpp"
+#include "../include/rlglTypes.hpp"
+#include "raymath.h"
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+// Per-type placement and LOD parameters
+struct PropKind {
+    float spacing;       // Minimum distance between props of this type (tiles)
+    float minScale, maxScale;
+    float minStretch, maxStretch;
+    float meshHeight;    // Height of the unscaled mesh
+    float lodStart;      // All instances drawn up to here
+    float maxDistance;   // None drawn beyond
+};
+
+static const PropKind PROP_KINDS[PROP_TYPE_COUNT] = {
+    // spacing  scale        stretch      height  lodStart  maxDistance
+    {2.0f,      0.3f, 0.9f,  0.5f, 0.9f,  0.6f,   40.0f,    120.0f},  // ROCK
+    {1.2f,      0.4f, 0.9f,  0.8f, 1.1f,  0.7f,   30.0f,    80.0f},   // SHRUB
+    {3.0f,      0.8f, 1.6f,  0.9f, 1.3f,  2.4f,   80.0f,    200.0f},  // TREE
+    {2.5f,      0.4f, 1.2f,  1.0f, 2.0f,  1.2f,   60.0f,    160.0f},  // CRYSTAL
+};
+
+// Simple deterministic hash for pseudo-random values
+static uint32_t hash(uint32_t x) {
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    x = (x >> 16) ^ x;
+    return x;
+}
+
+static float hashFloat(uint32_t seed) {
+    return static_cast<float>(hash(seed) & 0xFFFF) / 65535.0f;
+}
+
+static uint8_t packUnorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+static uint16_t packFixed16(float v) {
+    return static_cast<uint16_t>(std::clamp(std::lround(v), 0L, 65535L));
+}
+
+PackedPropInstance PackedPropInstance::pack(float localX, float y, float localZ, float scale,
+                                            float yaw, float stretch, Vector3 color) {
+    PackedPropInstance p;
+    p.position[0] = packFixed16(localX * POSITION_SCALE);
+    p.position[1] = packFixed16(y * HEIGHT_UNITS + HEIGHT_BIAS);
+    p.position[2] = packFixed16(localZ * POSITION_SCALE);
+
+    uint16_t r = static_cast<uint16_t>(std::lround(std::clamp(color.x, 0.0f, 1.0f) * 31.0f));
+    uint16_t g = static_cast<uint16_t>(std::lround(std::clamp(color.y, 0.0f, 1.0f) * 63.0f));
+    uint16_t b = static_cast<uint16_t>(std::lround(std::clamp(color.z, 0.0f, 1.0f) * 31.0f));
+    p.color = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+
+    p.scale = packUnorm8(scale / MAX_SCALE);
+    p.yaw = packUnorm8(yaw / (2.0f * PI));
+    p.stretch = packUnorm8(stretch / MAX_STRETCH);
+    p.reserved = 0;
+    return p;
+}
+
+// ============================================================================
+// Meshes
+// ============================================================================
+
+// Flat-shaded triangle list
+struct PropMeshBuilder {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> tints;
+
+    // Wound so the normal faces along hint
+    void triangle(Vector3 a, Vector3 b, Vector3 c, float tint, Vector3 hint) {
+        Vector3 n = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a)));
+        if (Vector3DotProduct(n, hint) < 0.0f) {
+            std::swap(b, c);
+            n = Vector3Negate(n);
+        }
+        for (const Vector3& v : {a, b, c}) {
+            positions.insert(positions.end(), {v.x, v.y, v.z});
+            normals.insert(normals.end(), {n.x, n.y, n.z});
+            tints.push_back(tint);
+        }
+    }
+
+    // Surface of revolution around the y axis through a profile of (radius,
+    // height) rings, bottom first. A zero radius is an apex; a bottom ring
+    // with a radius gets a cap. jitter scales the radius per side (or null).
+    void lathe(std::initializer_list<Vector2> profile, int sides, float tint, const float* jitter = nullptr) {
+        std::vector<Vector2> rings(profile);
+        auto at = [&](const Vector2& ring, int side) {
+            float angle = 2.0f * PI * side / sides;
+            float r = ring.x * (jitter ? jitter[side % sides] : 1.0f);
+            return Vector3{cosf(angle) * r, ring.y, sinf(angle) * r};
+        };
+        if (rings.front().x > 0.0f) {
+            Vector3 centre = {0.0f, rings.front().y, 0.0f};
+            for (int i = 0; i < sides; ++i) {
+                triangle(centre, at(rings.front(), i), at(rings.front(), i + 1), tint, {0.0f, -1.0f, 0.0f});
+            }
+        }
+        for (size_t k = 0; k + 1 < rings.size(); ++k) {
+            for (int i = 0; i < sides; ++i) {
+                Vector3 b0 = at(rings[k], i);
+                Vector3 b1 = at(rings[k], i + 1);
+                Vector3 t0 = at(rings[k + 1], i);
+                Vector3 t1 = at(rings[k + 1], i + 1);
+                float angle = 2.0f * PI * (i + 0.5f) / sides;
+                Vector3 out = {cosf(angle), 0.0f, sinf(angle)};
+                if (rings[k].x > 0.0f) triangle(b0, b1, t0, tint, out);
+                if (rings[k + 1].x > 0.0f) triangle(b1, t1, t0, tint, out);
+            }
+        }
+    }
+};
+
+static void buildPropMesh(PropType type, PropMeshBuilder& mesh) {
+    switch (type) {
+        case PropType::ROCK: {
+            // Lumpy boulder, sunk a little into the ground
+            static const float lumps[6] = {1.0f, 0.85f, 1.1f, 0.9f, 1.05f, 0.8f};
+            mesh.lathe({{0.45f, -0.1f}, {0.55f, 0.2f}, {0.35f, 0.5f}, {0.0f, 0.6f}}, 6, 1.0f, lumps);
+            break;
+        }
+        case PropType::SHRUB:
+            mesh.lathe({{0.3f, 0.0f}, {0.55f, 0.3f}, {0.4f, 0.6f}, {0.0f, 0.7f}}, 7, 1.0f);
+            break;
+        case PropType::TREE:
+            // Trunk in the trunk colour, two stacked cones of foliage
+            mesh.lathe({{0.09f, -0.1f}, {0.06f, 0.7f}}, 5, 0.0f);
+            mesh.lathe({{0.6f, 0.5f}, {0.0f, 1.6f}}, 7, 1.0f);
+            mesh.lathe({{0.45f, 1.2f}, {0.0f, 2.4f}}, 7, 1.0f);
+            break;
+        case PropType::CRYSTAL:
+            mesh.lathe({{0.18f, -0.1f}, {0.18f, 0.8f}, {0.0f, 1.2f}}, 6, 1.0f);
+            break;
+        default:
+            break;
+    }
+}
+
+PropMeshes& PropMeshes::getInstance() {
+    // Deliberately leaked: destroying it after CloseWindow would call into GL
+    static PropMeshes* instance = new PropMeshes();
+    return *instance;
+}
+
+const PropMeshes::Buffers& PropMeshes::get(PropType type) {
+    Buffers& b = buffers[static_cast<int>(type)];
+    if (b.vertexCount > 0) return b;
+
+    PropMeshBuilder mesh;
+    buildPropMesh(type, mesh);
+    b.vertexCount = (int)mesh.tints.size();
+    b.positions = rlLoadVertexBuffer(mesh.positions.data(), (int)(mesh.positions.size() * sizeof(float)), false);
+    b.normals = rlLoadVertexBuffer(mesh.normals.data(), (int)(mesh.normals.size() * sizeof(float)), false);
+    b.tints = rlLoadVertexBuffer(mesh.tints.data(), (int)(mesh.tints.size() * sizeof(float)), false);
+    rlDisableVertexBuffer();
+    PROFILE_COUNT("gl objects created", 3);
+    return b;
+}
+
+// ============================================================================
+// Placement
+// ============================================================================
+
+// Fraction of Poisson-disk sites kept on a tile
+static float propDensity(PropType type, const BiomeData& biome, const tile& t) {
+    const ScatterProps& scatter = biome.scatter;
+    float erosion = t.erosionFactor / 255.0f;
+    float magmatic = t.magmaticPotential / 255.0f;
+    float biological = t.biologicalPotential / 255.0f;
+    float crystalline = t.crystalinePotential / 255.0f;
+    switch (type) {
+        case PropType::ROCK:
+            // Exposed and volcanic ground is rockier
+            return scatter.rockDensity + erosion * 0.25f + magmatic * 0.2f;
+        case PropType::SHRUB:
+            return scatter.shrubDensity * (0.5f + biological);
+        case PropType::TREE:
+            return scatter.treeDensity * (0.4f + 1.2f * biological) * (1.0f - erosion);
+        case PropType::CRYSTAL:
+            return scatter.crystalDensity + (biome.hasCrystalSpires ? 0.15f : 0.0f) +
+                   std::max(0.0f, crystalline - 0.6f) * 1.5f;
+        default:
+            return 0.0f;
+    }
+}
+
+static Vector3 propColor(PropType type, const BiomeData& biome, const tile& t, float variation) {
+    float shade = 0.85f + 0.3f * variation;
+    Vector3 color;
+    switch (type) {
+        case PropType::ROCK: {
+            // Grey stone, darker basalt where the ground is volcanic
+            float magmatic = t.magmaticPotential / 255.0f;
+            color = Vector3Lerp({0.46f, 0.44f, 0.41f}, {0.18f, 0.16f, 0.16f}, magmatic);
+            break;
+        }
+        case PropType::SHRUB:
+            color = Vector3Scale(Vector3Lerp(biome.grass.baseColor, biome.grass.tipColor, 0.5f), 1.1f);
+            break;
+        case PropType::TREE:
+            color = biome.grass.baseColor;
+            break;
+        case PropType::CRYSTAL:
+            color = Vector3Lerp({0.55f, 0.80f, 0.95f}, {0.75f, 0.55f, 0.95f}, variation);
+            shade = 1.0f;
+            break;
+        default:
+            color = {1.0f, 1.0f, 1.0f};
+            break;
+    }
+    return Vector3Scale(color, shade);
+}
+
+// Candidate of a world grid cell: jittered position and priority
+struct PropCandidate {
+    float x, z;
+    float priority;
+    uint32_t seed;
+};
+
+static PropCandidate propCandidate(int type, int cx, int cz, float spacing) {
+    uint32_t seed = hash(static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cz) * 19349663u ^
+                         static_cast<uint32_t>(type + 1) * 83492791u);
+    return {(cx + hashFloat(seed)) * spacing, (cz + hashFloat(seed + 1)) * spacing, hashFloat(seed + 2), seed};
+}
+
+void PropField::build(PropInstanceData& out, tileGrid& tiles, int originX, int originZ) {
+    PROFILE_SCOPE("PropField::build");
+    out.clear();
+    out.originX = originX;
+    out.originZ = originZ;
+
+    const BiomeManager& biomeMan = BiomeManager::getInstance();
+    const int width = (int)tiles.getWidth();
+    const int height = (int)tiles.getHeight();
+    ScratchScope scratch;
+    std::pmr::vector<std::pair<float, PackedPropInstance>> ordered(scratch.resource());
+
+    for (int type = 0; type < PROP_TYPE_COUNT; ++type) {
+        const PropKind& kind = PROP_KINDS[type];
+        const float s = kind.spacing;
+        int cx0 = (int)std::floor(originX / s);
+        int cz0 = (int)std::floor(originZ / s);
+        int cx1 = (int)std::floor((originX + width) / s);
+        int cz1 = (int)std::floor((originZ + height) / s);
+        ordered.clear();
+
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                PropCandidate c = propCandidate(type, cx, cz, s);
+                float lx = c.x - originX;
+                float lz = c.z - originZ;
+                if (lx < 0.0f || lx >= width || lz < 0.0f || lz >= height) continue;
+
+                // Kept if no candidate closer than the spacing outranks it.
+                // Cells are spacing wide, so only the 8 around can be closer.
+                bool kept = true;
+                for (int dz = -1; dz <= 1 && kept; ++dz) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (dx == 0 && dz == 0) continue;
+                        PropCandidate n = propCandidate(type, cx + dx, cz + dz, s);
+                        float ddx = n.x - c.x;
+                        float ddz = n.z - c.z;
+                        if (ddx * ddx + ddz * ddz >= s * s) continue;
+                        if (n.priority > c.priority || (n.priority == c.priority && n.seed > c.seed)) {
+                            kept = false;
+                            break;
+                        }
+                    }
+                }
+                if (!kept) continue;
+
+                int tx = std::min((int)lx, width - 1);
+                int tz = std::min((int)lz, height - 1);
+                tile t = tiles.getTile(tx, tz);
+                // Machines are stored transposed (grid[y][x]), so ask the grid
+                if (t.waterLevel > 0 || t.riverWidth > 0 || tiles.getMachineAt(tx, tz)) continue;
+                const BiomeData& biome = biomeMan.getBiomeData(t.biome);
+                float density = std::clamp(propDensity(static_cast<PropType>(type), biome, t), 0.0f, 1.0f);
+                if (hashFloat(c.seed + 3) >= density) continue;
+
+                // Ground height: bilinear over the tile's corners (TL, TR, BR, BL)
+                float fx = lx - tx;
+                float fz = lz - tz;
+                float y = (t.tileHeight[0] * (1.0f - fx) + t.tileHeight[1] * fx) * (1.0f - fz) +
+                          (t.tileHeight[3] * (1.0f - fx) + t.tileHeight[2] * fx) * fz;
+
+                float scale = kind.minScale + (kind.maxScale - kind.minScale) * hashFloat(c.seed + 4);
+                float stretch = kind.minStretch + (kind.maxStretch - kind.minStretch) * hashFloat(c.seed + 5);
+                float yaw = hashFloat(c.seed + 6) * 2.0f * PI;
+                Vector3 color = propColor(static_cast<PropType>(type), biome, t, hashFloat(c.seed + 7));
+                ordered.push_back({hashFloat(c.seed + 8),
+                                   PackedPropInstance::pack(lx, y, lz, scale, yaw, stretch, color)});
+                out.top = std::max(out.top, y + kind.meshHeight * scale * stretch);
+            }
+        }
+
+        // Random order: any prefix is an even subsample for distance LOD
+        std::sort(ordered.begin(), ordered.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<PackedPropInstance>& instances = out.instances[type];
+        instances.reserve(ordered.size());
+        for (const auto& entry : ordered) instances.push_back(entry.second);
+    }
+}
+
+// ============================================================================
+// GPU
+// ============================================================================
+
+PropField::~PropField() {
+    clear();
+}
+
+void PropField::upload(const PropInstanceData& data) {
+    originX = static_cast<float>(data.originX);
+    originZ = static_cast<float>(data.originZ);
+    top = data.top;
+    for (int type = 0; type < PROP_TYPE_COUNT; ++type) {
+        uploadLayer(static_cast<PropType>(type), data.instances[type]);
+    }
+}
+
+void PropField::uploadLayer(PropType type, const std::vector<PackedPropInstance>& instances) {
+    Layer& layer = layers[static_cast<int>(type)];
+    layer.count = instances.size();
+    if (layer.count == 0) return;
+    int bytes = (int)(layer.count * sizeof(PackedPropInstance));
+
+    // Refill the existing instance buffer when the new props fit
+    if (layer.vboInstances != 0 && layer.count <= layer.capacity) {
+        rlUpdateVertexBuffer(layer.vboInstances, instances.data(), bytes, 0);
+        rlDisableVertexBuffer();
+        PROFILE_COUNT("gl buffer refills", 1);
+        return;
+    }
+
+    if (layer.vboInstances != 0) {
+        rlUnloadVertexBuffer(layer.vboInstances);
+        PROFILE_COUNT("gl objects deleted", 1);
+    }
+    const PropMeshes::Buffers& mesh = PropMeshes::getInstance().get(type);
+    if (layer.vaoId == 0) {
+        // Shared mesh buffers: position, normal, tint
+        layer.vaoId = rlLoadVertexArray();
+        rlEnableVertexArray(layer.vaoId);
+        rlEnableVertexBuffer(mesh.positions);
+        rlSetVertexAttribute(0, 3, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(0);
+        rlEnableVertexBuffer(mesh.normals);
+        rlSetVertexAttribute(1, 3, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(1);
+        rlEnableVertexBuffer(mesh.tints);
+        rlSetVertexAttribute(2, 1, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(2);
+        PROFILE_COUNT("gl objects created", 1);
+    } else {
+        rlEnableVertexArray(layer.vaoId);
+    }
+
+    // Headroom so a recycled chunk with a few more props still fits
+    layer.capacity = layer.count + layer.count / 4;
+    layer.vboInstances = rlLoadVertexBuffer(nullptr, (int)(layer.capacity * sizeof(PackedPropInstance)), true);
+    rlUpdateVertexBuffer(layer.vboInstances, instances.data(), bytes, 0);
+    rlEnableVertexBuffer(layer.vboInstances);
+    const int stride = sizeof(PackedPropInstance);
+
+    // Location 3: position + RGB565 colour as raw integers
+    rlEnableVertexAttribute(3);
+    rlSetVertexAttribute(3, 4, RL_UNSIGNED_SHORT, false, stride, offsetof(PackedPropInstance, position));
+    rlSetVertexAttributeDivisor(3, 1);
+
+    // Location 4: scale, yaw, stretch, unused (unorm8)
+    rlEnableVertexAttribute(4);
+    rlSetVertexAttribute(4, 4, RL_UNSIGNED_BYTE, true, stride, offsetof(PackedPropInstance, scale));
+    rlSetVertexAttributeDivisor(4, 1);
+
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+    PROFILE_COUNT("gl objects created", 1);
+}
+
+void PropField::resetInstances() {
+    for (Layer& layer : layers) layer.count = 0;
+    top = -1e30f;
+}
+
+void PropField::clear() {
+    for (Layer& layer : layers) {
+        if (layer.vboInstances != 0) {
+            rlUnloadVertexBuffer(layer.vboInstances);
+            PROFILE_COUNT("gl objects deleted", 1);
+        }
+        if (layer.vaoId != 0) {
+            rlUnloadVertexArray(layer.vaoId);
+            PROFILE_COUNT("gl objects deleted", 1);
+        }
+        layer = Layer{};
+    }
+    top = -1e30f;
+}
+
+bool PropField::draw(PropType type, float density) const {
+    const Layer& layer = layers[static_cast<int>(type)];
+    if (layer.count == 0 || layer.vaoId == 0) return false;
+    size_t instances = std::min(layer.count, (size_t)std::ceil(layer.count * std::clamp(density, 0.0f, 1.0f)));
+    if (instances == 0) return false;
+
+    PropShaderLocs& locs = resourceManager::getPropShaderLocs();
+    if (locs.chunkOrigin != -1) {
+        float origin[2] = {originX, originZ};
+        rlSetUniform(locs.chunkOrigin, origin, SHADER_UNIFORM_VEC2, 1);
+    }
+    // Full count, so each prop knows its rank in the random order
+    if (locs.instanceCount != -1) {
+        float total = static_cast<float>(layer.count);
+        rlSetUniform(locs.instanceCount, &total, SHADER_UNIFORM_FLOAT, 1);
+    }
+
+    if (!rlEnableVertexArray(layer.vaoId)) return false;
+    rlDrawVertexArrayInstanced(0, PropMeshes::getInstance().get(type).vertexCount, static_cast<int>(instances));
+    rlDisableVertexArray();
+    return true;
+}
+
+size_t PropField::getInstanceCount() const {
+    size_t total = 0;
+    for (const Layer& layer : layers) total += layer.count;
+    return total;
+}
+
+size_t PropField::getGpuBytes() const {
+    size_t bytes = 0;
+    for (const Layer& layer : layers) {
+        if (layer.vboInstances != 0) bytes += layer.capacity * sizeof(PackedPropInstance);
+    }
+    return bytes;
+}
+
+float PropField::getLodStart(PropType type) {
+    return PROP_KINDS[static_cast<int>(type)].lodStart;
+}
+
+float PropField::getMaxDistance(PropType type) {
+    return PROP_KINDS[static_cast<int>(type)].maxDistance;
+}
+
+float PropField::lodDensity(PropType type, float distance) {
+    const PropKind& kind = PROP_KINDS[static_cast<int>(type)];
+    return std::clamp((kind.maxDistance - distance) / (kind.maxDistance - kind.lodStart), 0.0f, 1.0f);
+}
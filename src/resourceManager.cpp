@@ -1,5 +1,6 @@
 #include "../include/resourceManager.hpp"
 #include "../include/visualSettings.hpp"
+#include "../include/grass.hpp"
 #include <raylib.h>
 
 // Define SHADER_LOC_VERTEX_INSTANCE_TX for raylib 5.5 compatibility
@@ -18,9 +19,11 @@ Shader resourceManager::terrainShader;
 Shader resourceManager::waterShader;
 Shader resourceManager::grassShader;
 Material resourceManager::grassMaterial;
+Shader resourceManager::propShader;
 TerrainShaderLocs resourceManager::terrainLocs = {0};
 WaterShaderLocs resourceManager::waterLocs = {0};
 GrassShaderLocs resourceManager::grassLocs = {0};
+PropShaderLocs resourceManager::propLocs = {0};
 std::unordered_map<machineType, std::string> resourceManager::modelPaths = {
     { CONVEYORMK1, "assets/models/conveyor_mk1.glb" },
     { DRILLMK1,    "assets/models/drill_mk1.glb" }
@@ -56,6 +59,7 @@ void resourceManager::cacheShaderLocations() {
     terrainLocs.stoneExposedU = GetShaderLocation(terrainShader, "stoneExposedU");
     // Visualization mode
     terrainLocs.visualizationMode = GetShaderLocation(terrainShader, "visualizationMode");
+    terrainLocs.packedVertices = GetShaderLocation(terrainShader, "packedVertices");
     
     // Cache water shader uniform locations
     waterLocs.waterHue = GetShaderLocation(waterShader, "waterHue");
@@ -72,13 +76,21 @@ void resourceManager::cacheShaderLocations() {
     grassShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(grassShader, "mvp");
     grassShader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(grassShader, "viewPos");
     
-    // CRITICAL: Set instance transform attribute location for DrawMeshInstanced to work!
-    // This tells raylib where to bind the per-instance transform matrices
-    grassShader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] = GetShaderLocationAttrib(grassShader, "instanceTransform");
-    
     grassLocs.mvp = grassShader.locs[SHADER_LOC_MATRIX_MVP];
     grassLocs.viewPos = grassShader.locs[SHADER_LOC_VECTOR_VIEW];
     grassLocs.time = GetShaderLocation(grassShader, "time");
+    grassLocs.chunkOrigin = GetShaderLocation(grassShader, "chunkOrigin");
+    grassLocs.bladeCount = GetShaderLocation(grassShader, "bladeCount");
+    grassLocs.lodSpacing = GetShaderLocation(grassShader, "lodSpacing");
+    grassLocs.lodReduction = GetShaderLocation(grassShader, "lodReduction");
+    grassLocs.lodMaxLevel = GetShaderLocation(grassShader, "lodMaxLevel");
+    grassLocs.fadeStart = GetShaderLocation(grassShader, "fadeStart");
+    grassLocs.fadeEnd = GetShaderLocation(grassShader, "fadeEnd");
+    grassLocs.baseHeightScale = GetShaderLocation(grassShader, "baseHeightScale");
+    grassLocs.heightVariation = GetShaderLocation(grassShader, "heightVariation");
+    grassLocs.dirtBlendColor = GetShaderLocation(grassShader, "dirtBlendColor");
+    grassLocs.dirtBlendDistance = GetShaderLocation(grassShader, "dirtBlendDistance");
+    grassLocs.dirtBlendStrength = GetShaderLocation(grassShader, "dirtBlendStrength");
     grassLocs.windStrength = GetShaderLocation(grassShader, "windStrength");
     grassLocs.windDirection = GetShaderLocation(grassShader, "windDirection");
     grassLocs.windSpeed = GetShaderLocation(grassShader, "windSpeed");
@@ -114,6 +126,21 @@ void resourceManager::cacheShaderLocations() {
     // Cache temperature threshold uniforms - hot
     grassLocs.desertStartTemp = GetShaderLocation(grassShader, "desertStartTemp");
     grassLocs.desertFullTemp = GetShaderLocation(grassShader, "desertFullTemp");
+
+    // Cache prop shader uniform locations
+    propShader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(propShader, "mvp");
+    propShader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(propShader, "viewPos");
+    propLocs.mvp = propShader.locs[SHADER_LOC_MATRIX_MVP];
+    propLocs.viewPos = propShader.locs[SHADER_LOC_VECTOR_VIEW];
+    propLocs.chunkOrigin = GetShaderLocation(propShader, "chunkOrigin");
+    propLocs.instanceCount = GetShaderLocation(propShader, "instanceCount");
+    propLocs.lodStart = GetShaderLocation(propShader, "lodStart");
+    propLocs.lodEnd = GetShaderLocation(propShader, "lodEnd");
+    propLocs.trunkColor = GetShaderLocation(propShader, "trunkColor");
+    propLocs.sunDirection = GetShaderLocation(propShader, "sunDirection");
+    propLocs.sunColor = GetShaderLocation(propShader, "sunColor");
+    propLocs.ambientStrength = GetShaderLocation(propShader, "ambientStrength");
+    propLocs.ambientColor = GetShaderLocation(propShader, "ambientColor");
 }
 
 void resourceManager::initialize() {
@@ -125,6 +152,7 @@ void resourceManager::initialize() {
     terrainShader = LoadShader("assets/shaders/terrainShader.vs", "assets/shaders/terrainShader.fs");
     waterShader   = LoadShader("assets/shaders/waterShader.vs",   "assets/shaders/waterShader.fs");
     grassShader   = LoadShader("assets/shaders/grassShader.vs",   "assets/shaders/grassShader.fs");
+    propShader    = LoadShader("assets/shaders/propShader.vs",    "assets/shaders/propShader.fs");
     waterTexture = LoadTexture("assets/textures/water.png");
     waterDisplacementTexture = LoadTexture("assets/textures/waterDisplacement.png");
     
@@ -259,6 +287,7 @@ void resourceManager::cleanup() {
     UnloadShader(terrainShader);
     UnloadShader(waterShader);
     UnloadShader(grassShader);
+    UnloadShader(propShader);
     // Note: grassMaterial uses grassShader which is already unloaded above
     // Material doesn't own resources, so no separate unload needed
 
@@ -329,6 +358,16 @@ void resourceManager::updateGrassUniforms(float time, Vector3 cameraPos,
     SetShaderValue(grassShader, grassLocs.shiftDisplacement, &shiftDisplacement, SHADER_UNIFORM_FLOAT);
 }
 
+// Update prop shader uniforms
+void resourceManager::updatePropUniforms(Vector3 cameraPos, Vector3 sunDirection, Vector3 sunColor,
+                                         float ambientStrength, Vector3 ambientColor) {
+    SetShaderValue(propShader, propLocs.viewPos, &cameraPos, SHADER_UNIFORM_VEC3);
+    SetShaderValue(propShader, propLocs.sunDirection, &sunDirection, SHADER_UNIFORM_VEC3);
+    SetShaderValue(propShader, propLocs.sunColor, &sunColor, SHADER_UNIFORM_VEC3);
+    SetShaderValue(propShader, propLocs.ambientStrength, &ambientStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(propShader, propLocs.ambientColor, &ambientColor, SHADER_UNIFORM_VEC3);
+}
+
 Shader& resourceManager::getGrassShader() {
     return grassShader;
 }
@@ -341,6 +380,18 @@ GrassShaderLocs& resourceManager::getGrassShaderLocs() {
     return grassLocs;
 }
 
+Shader& resourceManager::getPropShader() {
+    return propShader;
+}
+
+PropShaderLocs& resourceManager::getPropShaderLocs() {
+    return propLocs;
+}
+
+TerrainShaderLocs& resourceManager::getTerrainShaderLocs() {
+    return terrainLocs;
+}
+
 void resourceManager::applyVisualSettings() {
     VisualSettings& vs = VisualSettings::getInstance();
     
@@ -404,6 +455,25 @@ void resourceManager::applyVisualSettings() {
     SetShaderValue(grassShader, grassLocs.windSpeed, &grass.windSpeed, SHADER_UNIFORM_FLOAT);
     SetShaderValue(grassShader, grassLocs.windDirection, windDir, SHADER_UNIFORM_VEC2);
     
+    // Distance LOD: same bands chunkManager::renderGrass picks instance counts from
+    float lodSpacing = grass.lodSpacing();
+    float lodReduction = std::clamp(grass.lodReduction, 0.0f, 1.0f);
+    float lodMaxLevel = (float)(std::max(1, grass.lodLevels) - 1);
+    SetShaderValue(grassShader, grassLocs.lodSpacing, &lodSpacing, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.lodReduction, &lodReduction, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.lodMaxLevel, &lodMaxLevel, SHADER_UNIFORM_FLOAT);
+    float fadeStart = std::min(grass.fadeStartDistance, grass.renderDistance);
+    SetShaderValue(grassShader, grassLocs.fadeStart, &fadeStart, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.fadeEnd, &grass.renderDistance, SHADER_UNIFORM_FLOAT);
+    
+    // Height and dirt blend: uniforms, so tweaking them rebuilds no grass
+    float baseHeightScale = grass.baseHeight / GrassField::BLADE_BASE_HEIGHT;
+    SetShaderValue(grassShader, grassLocs.baseHeightScale, &baseHeightScale, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.heightVariation, &grass.heightVariation, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.dirtBlendColor, &grass.dirtBlendColor, SHADER_UNIFORM_VEC3);
+    SetShaderValue(grassShader, grassLocs.dirtBlendDistance, &grass.dirtBlendDistance, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(grassShader, grassLocs.dirtBlendStrength, &grass.dirtBlendStrength, SHADER_UNIFORM_FLOAT);
+    
     // Apply water settings
     WaterSettings& water = vs.getWaterSettings();
     SetShaderValue(waterShader, waterLocs.waterHue, &water.hueShift, SHADER_UNIFORM_FLOAT);
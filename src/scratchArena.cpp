@@ -0,0 +1,131 @@
+#include "../include/scratchArena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<int64_t> scopedHeapAllocations{0};
+static std::atomic<int64_t> reservedBytes{0};
+// Open scopes on this thread. A plain int, not a member of the arena, so
+// operator new can read it without constructing the thread's arena.
+static thread_local int scopedDepth = 0;
+
+static constexpr size_t GROWTH_STEP = 64 * 1024;
+
+ScratchArena::ScratchArena() {
+    base = head = allocateBlock(INITIAL_BYTES, nullptr);
+}
+
+ScratchArena::~ScratchArena() {
+    while (head) {
+        Block* prev = head->prev;
+        freeBlock(head);
+        head = prev;
+    }
+}
+
+ScratchArena& ScratchArena::forThread() {
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+int64_t ScratchArena::getScopedHeapAllocations() {
+    return scopedHeapAllocations.load(std::memory_order_relaxed);
+}
+
+int64_t ScratchArena::getReservedBytes() {
+    return reservedBytes.load(std::memory_order_relaxed);
+}
+
+ScratchArena::Block* ScratchArena::allocateBlock(size_t size, Block* prev) {
+    Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+    block->prev = prev;
+    block->size = size;
+    reservedBytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+    return block;
+}
+
+void ScratchArena::freeBlock(Block* block) {
+    reservedBytes.fetch_sub((int64_t)block->size, std::memory_order_relaxed);
+    ::operator delete(block);
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    char* data = reinterpret_cast<char*>(head + 1);
+    uintptr_t p = (reinterpret_cast<uintptr_t>(data + offset) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (p + bytes > reinterpret_cast<uintptr_t>(data + head->size)) {
+        // Overflow: chain a block for the rest of the scope; rewind() folds
+        // it into the base block later
+        head = allocateBlock(std::max(bytes + alignment, base->size), head);
+        data = reinterpret_cast<char*>(head + 1);
+        offset = 0;
+        p = (reinterpret_cast<uintptr_t>(data) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    size_t end = p + bytes - reinterpret_cast<uintptr_t>(data);
+    used += end - offset;
+    offset = end;
+    highWater = std::max(highWater, used);
+    return reinterpret_cast<void*>(p);
+}
+
+void ScratchArena::rewind(const Mark& m) {
+    while (head != m.block) {
+        Block* prev = head->prev;
+        freeBlock(head);
+        head = prev;
+    }
+    offset = m.offset;
+    used = m.used;
+
+    // Nothing is live at depth 0: replace the base block with one that
+    // holds the whole high-water mark, plus some headroom
+    if (depth == 0 && highWater > base->size) {
+        size_t size = highWater + highWater / 4;
+        size = (size + GROWTH_STEP - 1) / GROWTH_STEP * GROWTH_STEP;
+        freeBlock(base);
+        base = head = allocateBlock(size, nullptr);
+        offset = 0;
+        used = 0;
+    }
+}
+
+ScratchScope::ScratchScope() : arena(ScratchArena::forThread()), start(arena.mark()) {
+    arena.depth++;
+    scopedDepth++;
+}
+
+ScratchScope::~ScratchScope() {
+    scopedDepth--;
+    arena.depth--;
+    arena.rewind(start);
+}
+
+#ifdef TILEGRID_PROFILE
+// Count global heap allocations made inside scratch scopes. Streaming
+// chunks in steady state should leave this counter flat.
+void* operator new(std::size_t size) {
+    if (scopedDepth > 0) scopedHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#endif
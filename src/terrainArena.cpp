@@ -0,0 +1,291 @@
+#include "../include/terrainArena.hpp"
+#include "../include/terrainMesh.hpp"
+#include "../include/resourceManager.hpp"
+#include "../include/profiling.hpp"
+#include "../include/rlglTypes.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <raymath.h>
+
+// Vertices per arena at each detail level: about five full chunks, a region
+// of level 1 meshes in two arenas, and one for level 2
+static const int ARENA_CAPACITY[TERRAIN_LOD_LEVELS] = {1 << 16, 1 << 15, 1 << 14};
+
+// Upload scratch (main thread only)
+static std::vector<PackedTerrainVertex> staging;
+static std::vector<PackedTerrainVertex> zeros;
+
+TerrainArena::TerrainArena(int capacity) : capacity(capacity) {
+    vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(vaoId);
+
+    // Start all degenerate
+    if ((int)zeros.size() < capacity) zeros.resize(capacity, PackedTerrainVertex{});
+    vboId = rlLoadVertexBuffer(zeros.data(), capacity * (int)sizeof(PackedTerrainVertex), true);
+    PROFILE_COUNT("gl objects created", 2);
+    const int stride = sizeof(PackedTerrainVertex);
+
+    // Bound to raylib's default attribute locations so the shader needs no extra setup
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 4, RL_SHORT, false, stride,
+                         offsetof(PackedTerrainVertex, position));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 2, RL_BYTE, true, stride,
+                         offsetof(PackedTerrainVertex, normal));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL);
+
+    // Atlas cell and corner bits arrive in vertexTexCoord as raw integers
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_UNSIGNED_BYTE, false, stride,
+                         offsetof(PackedTerrainVertex, atlasCell));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, stride,
+                         offsetof(PackedTerrainVertex, color));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+
+    freeRanges[0] = capacity;
+}
+
+TerrainArena::~TerrainArena() {
+    if (vboId != 0) rlUnloadVertexBuffer(vboId);
+    if (vaoId != 0) rlUnloadVertexArray(vaoId);
+    PROFILE_COUNT("gl objects deleted", 2);
+}
+
+TerrainArena::Block* TerrainArena::allocate(int count) {
+    // Adjacent marked blocks are drawn as one run, so every block must start
+    // on a whole triangle: with all sizes a multiple of 3, so are all offsets
+    count = (count + 2) / 3 * 3;
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second < count) continue;
+        int offset = it->first;
+        int remaining = it->second - count;
+        freeRanges.erase(it);
+        if (remaining > 0) freeRanges[offset + count] = remaining;
+
+        assert(offset % 3 == 0);
+        Block& block = blocks[offset];
+        block.offset = offset;
+        block.capacity = count;
+        block.drawFrame = 0;
+        return &block;
+    }
+    return nullptr;
+}
+
+void TerrainArena::release(Block* block, int written) {
+    int offset = block->offset;
+    int size = block->capacity;
+    zero(offset, written);
+    blocks.erase(offset);
+
+    // Coalesce with the free ranges on either side
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.end() && next->first == offset + size) {
+        size += next->second;
+        next = freeRanges.erase(next);
+    }
+    if (next != freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+    freeRanges[offset] = size;
+}
+
+void TerrainArena::write(int first, const PackedTerrainVertex* vertices, int count, int16_t offsetX, int16_t offsetZ) {
+    if (count <= 0) return;
+    // Zeroed row padding moves too, but its triangles stay degenerate
+    staging.assign(vertices, vertices + count);
+    for (PackedTerrainVertex& v : staging) {
+        v.position[0] += offsetX;
+        v.position[2] += offsetZ;
+    }
+    rlUpdateVertexBuffer(vboId, staging.data(), count * (int)sizeof(PackedTerrainVertex),
+                         first * (int)sizeof(PackedTerrainVertex));
+}
+
+void TerrainArena::zero(int first, int count) {
+    if (count <= 0) return;
+    if ((int)zeros.size() < count) zeros.resize(count, PackedTerrainVertex{});
+    rlUpdateVertexBuffer(vboId, zeros.data(), count * (int)sizeof(PackedTerrainVertex),
+                         first * (int)sizeof(PackedTerrainVertex));
+}
+
+int TerrainArena::drawMarked(uint32_t frame) const {
+    int draws = 0;
+    int runStart = -1;
+    int runEnd = 0;
+    bool bound = false;
+    auto flush = [&]() {
+        if (runStart < 0) return;
+        if (!bound) {
+            bound = rlEnableVertexArray(vaoId);
+            if (!bound) return;
+        }
+        rlDrawVertexArray(runStart, runEnd - runStart);
+        draws++;
+        runStart = -1;
+    };
+
+    // Free space between marked blocks is degenerate, so only an unmarked
+    // block breaks a run
+    for (const auto& pair : blocks) {
+        const Block& block = pair.second;
+        if (block.drawFrame != frame) {
+            flush();
+            continue;
+        }
+        if (runStart < 0) runStart = block.offset;
+        runEnd = block.offset + block.capacity;
+    }
+    flush();
+    if (bound) rlDisableVertexArray();
+    return draws;
+}
+
+TerrainArenas& TerrainArenas::getInstance() {
+    // Deliberately leaked: destroying it after CloseWindow would call into GL
+    static TerrainArenas* instance = new TerrainArenas();
+    return *instance;
+}
+
+static uint64_t regionKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+TerrainArenas::Allocation TerrainArenas::allocate(int regionX, int regionY, int level, int count) {
+    Allocation allocation;
+    if (count <= 0) return allocation;
+
+    Region& region = regions[regionKey(regionX, regionY)];
+    region.x = regionX;
+    region.y = regionY;
+    std::vector<std::unique_ptr<TerrainArena>>& arenas = region.arenas[level];
+    for (const std::unique_ptr<TerrainArena>& arena : arenas) {
+        if (TerrainArena::Block* block = arena->allocate(count)) {
+            allocation = {&region, arena.get(), block};
+            break;
+        }
+    }
+    if (!allocation.block) {
+        // Take a spare arena if one is big enough, otherwise create one
+        std::unique_ptr<TerrainArena> arena;
+        std::vector<std::unique_ptr<TerrainArena>>& pool = spare[level];
+        auto fit = std::find_if(pool.begin(), pool.end(), [&](const std::unique_ptr<TerrainArena>& a) {
+            return a->getCapacity() >= count;
+        });
+        if (fit != pool.end()) {
+            arena = std::move(*fit);
+            pool.erase(fit);
+        } else {
+            arena = std::make_unique<TerrainArena>(std::max(ARENA_CAPACITY[level], count));
+            PROFILE_COUNT("terrain arenas created", 1);
+        }
+        allocation = {&region, arena.get(), arena->allocate(count)};
+        arenas.push_back(std::move(arena));
+    }
+    region.blocks++;
+    return allocation;
+}
+
+void TerrainArenas::release(Allocation& allocation, int written) {
+    if (!allocation.block) return;
+    allocation.arena->release(allocation.block, written);
+
+    Region* region = allocation.region;
+    allocation = Allocation{};
+    if (--region->blocks > 0) return;
+
+    // Empty region: every arena is all zeroes again, keep them for reuse
+    for (int level = 0; level < TERRAIN_LOD_LEVELS; ++level) {
+        for (std::unique_ptr<TerrainArena>& arena : region->arenas[level]) {
+            spare[level].push_back(std::move(arena));
+        }
+    }
+    regions.erase(regionKey(region->x, region->y));
+}
+
+void TerrainArenas::mark(const Allocation& allocation, uint32_t frame) {
+    if (!allocation.block) return;
+    allocation.block->drawFrame = frame;
+    allocation.region->drawFrame = frame;
+}
+
+int TerrainArenas::draw(uint32_t frame) {
+    Shader& shader = resourceManager::getShader(0);
+    TerrainShaderLocs& locs = resourceManager::getTerrainShaderLocs();
+
+    rlEnableShader(shader.id);
+
+    int textureSlot = 0;
+    rlActiveTextureSlot(textureSlot);
+    rlEnableTexture(resourceManager::terrainTexture.id);
+    if (shader.locs[SHADER_LOC_MAP_DIFFUSE] != -1) {
+        rlSetUniform(shader.locs[SHADER_LOC_MAP_DIFFUSE], &textureSlot, SHADER_UNIFORM_INT, 1);
+    }
+
+    // The terrain shader is shared with machine models, which use raylib's float layout
+    int packed = 1;
+    if (locs.packedVertices != -1) rlSetUniform(locs.packedVertices, &packed, SHADER_UNIFORM_INT, 1);
+
+    Matrix matView = rlGetMatrixModelview();
+    Matrix matProjection = rlGetMatrixProjection();
+    Matrix matViewProj = MatrixMultiply(matView, matProjection);
+    int draws = 0;
+    for (auto& pair : regions) {
+        Region& region = pair.second;
+        if (region.drawFrame != frame) continue;
+
+        // Same matrix setup DrawMesh does for a model placed at the region origin
+        Matrix matModel = MatrixMultiply(MatrixTranslate((float)(region.x * REGION_SIZE), 0.0f, (float)(region.y * REGION_SIZE)),
+                                         rlGetMatrixTransform());
+        if (shader.locs[SHADER_LOC_MATRIX_MVP] != -1) {
+            rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(matModel, matViewProj));
+        }
+        if (shader.locs[SHADER_LOC_MATRIX_MODEL] != -1) rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MODEL], matModel);
+        if (shader.locs[SHADER_LOC_MATRIX_NORMAL] != -1) {
+            rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_NORMAL], MatrixTranspose(MatrixInvert(matModel)));
+        }
+
+        for (int level = 0; level < TERRAIN_LOD_LEVELS; ++level) {
+            for (const std::unique_ptr<TerrainArena>& arena : region.arenas[level]) {
+                draws += arena->drawMarked(frame);
+            }
+        }
+    }
+
+    packed = 0;
+    if (locs.packedVertices != -1) rlSetUniform(locs.packedVertices, &packed, SHADER_UNIFORM_INT, 1);
+
+    rlDisableTexture();
+    rlDisableShader();
+    return draws;
+}
+
+size_t TerrainArenas::getArenaCount() const {
+    size_t count = 0;
+    for (const auto& pair : regions) {
+        for (const auto& arenas : pair.second.arenas) count += arenas.size();
+    }
+    for (const auto& pool : spare) count += pool.size();
+    return count;
+}
+
+size_t TerrainArenas::getGpuBytes() const {
+    size_t bytes = 0;
+    auto add = [&](const std::vector<std::unique_ptr<TerrainArena>>& arenas) {
+        for (const auto& arena : arenas) bytes += (size_t)arena->getCapacity() * sizeof(PackedTerrainVertex);
+    };
+    for (const auto& pair : regions) {
+        for (const auto& arenas : pair.second.arenas) add(arenas);
+    }
+    for (const auto& pool : spare) add(pool);
+    return bytes;
+}
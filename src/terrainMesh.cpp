@@ -0,0 +1,96 @@
+#include "../include/terrainMesh.hpp"
+#include "../include/profiling.hpp"
+#include <cmath>
+#include <algorithm>
+
+static int8_t packSnorm8(float v) {
+    return static_cast<int8_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+}
+
+PackedTerrainVertex PackedTerrainVertex::pack(Vector3 position, Vector3 normal,
+                                              uint8_t atlasCell, uint8_t corner, Color color) {
+    PackedTerrainVertex v;
+    v.position[0] = static_cast<int16_t>(std::lround(position.x * POSITION_SCALE));
+    v.position[1] = static_cast<int16_t>(std::lround(position.y * POSITION_SCALE));
+    v.position[2] = static_cast<int16_t>(std::lround(position.z * POSITION_SCALE));
+    v.position[3] = 0;
+
+    // Octahedral encoding: project onto the octahedron, fold the lower half over
+    float l1 = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    float u = l1 > 0.0f ? normal.x / l1 : 0.0f;
+    float w = l1 > 0.0f ? normal.y / l1 : 0.0f;
+    if (normal.z < 0.0f) {
+        float fu = (1.0f - fabsf(w)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float fw = (1.0f - fabsf(u)) * (w >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        w = fw;
+    }
+    v.normal[0] = packSnorm8(u);
+    v.normal[1] = packSnorm8(w);
+
+    v.atlasCell = atlasCell;
+    v.corner = corner;
+    v.color[0] = color.r;
+    v.color[1] = color.g;
+    v.color[2] = color.b;
+    v.color[3] = color.a;
+    return v;
+}
+
+TerrainMesh::~TerrainMesh() {
+    clear();
+}
+
+void TerrainMesh::setPlacement(int newRegionX, int newRegionY, int newLevel, int originX, int originZ) {
+    int16_t newOffsetX = static_cast<int16_t>(originX * PackedTerrainVertex::POSITION_SCALE);
+    int16_t newOffsetZ = static_cast<int16_t>(originZ * PackedTerrainVertex::POSITION_SCALE);
+    if (newRegionX == regionX && newRegionY == regionY && newLevel == level &&
+        newOffsetX == offsetX && newOffsetZ == offsetZ) {
+        return;
+    }
+    clear();
+    regionX = newRegionX;
+    regionY = newRegionY;
+    level = newLevel;
+    offsetX = newOffsetX;
+    offsetZ = newOffsetZ;
+}
+
+void TerrainMesh::upload(const PackedTerrainVertex* vertices, int count) {
+    if (count <= 0) {
+        clear();
+        return;
+    }
+
+    // Refill in place when the contents fit; stale vertices past the new end
+    // are zeroed so the block can be drawn whole
+    if (allocation.block && count <= allocation.block->capacity) {
+        allocation.arena->write(allocation.block->offset, vertices, count, offsetX, offsetZ);
+        if (written > count) allocation.arena->zero(allocation.block->offset + count, written - count);
+        vertexCount = written = count;
+        PROFILE_COUNT("gl buffer refills", 1);
+        return;
+    }
+
+    clear();
+    // Headroom so a recycled chunk with a few more walls still fits
+    allocation = TerrainArenas::getInstance().allocate(regionX, regionY, level, count + count / 4);
+    allocation.arena->write(allocation.block->offset, vertices, count, offsetX, offsetZ);
+    vertexCount = written = count;
+}
+
+void TerrainMesh::update(int first, const PackedTerrainVertex* vertices, int count) {
+    if (!allocation.block || count <= 0) return;
+    allocation.arena->write(allocation.block->offset + first, vertices, count, offsetX, offsetZ);
+    written = std::max(written, first + count);
+}
+
+void TerrainMesh::clear() {
+    TerrainArenas::getInstance().release(allocation, written);
+    vertexCount = 0;
+    written = 0;
+}
+
+void TerrainMesh::mark(uint32_t frame) const {
+    if (vertexCount > 0) TerrainArenas::getInstance().mark(allocation, frame);
+}
@@ -7,8 +7,11 @@
 #include <cmath>
 #include <raylib.h>
 #include <raymath.h>
+#include "rlgl.h"
 #include "../include/resourceManager.hpp"  // use shared shader
 #include <chrono>
+#include "../include/profiling.hpp"
+#include "../include/scratchArena.hpp"
 
 
 #pragma GCC diagnostic ignored "-Wchar-subscripts"
@@ -57,19 +60,156 @@ char getDominantType3(char c1, char c2, char c3) {
 }
 tileGrid::tileGrid(int width, int height) : width(width), height(height), depth(0) {
     grid.resize(width, std::vector<tile>(height));
+    for (int i = 0; i < 8; ++i) neighborChunks[i] = nullptr;
+    blocksX = (width + PICK_BLOCK - 1) / PICK_BLOCK;
+    blocksY = (height + PICK_BLOCK - 1) / PICK_BLOCK;
+    blockBounds.resize(blocksX * blocksY);
 }
 
 tileGrid::~tileGrid() {
-    // Clean up mesh resources
-    // Note: UnloadModel also unloads the associated mesh
-    if (meshGenerated) {
-        UnloadModel(model);
-        UnloadModel(waterModel);
+    // Clean up mesh resources (terrain and seam meshes release themselves)
+    unloadWaterModel();
+}
+
+void tileGrid::reset() {
+    for (std::vector<tile>& column : grid) {
+        std::fill(column.begin(), column.end(), tile{});
     }
+    for (int i = 0; i < 8; ++i) neighborChunks[i] = nullptr;
+
+    // Keep every buffer, just stop drawing it
+    terrainMesh.clear();
+    for (int s = 0; s < SEAM_COUNT; ++s) {
+        seamMeshes[s].clear();
+        seamDirty[s] = false;
+    }
+    for (TerrainMesh& lod : lodMeshes) lod.clear();
+    waterData.clear();
+    waterCells.clear();
+    waterTop = -FLT_MAX;
+    terrainRows.clear();
+
+    dirtyRect = {0, 0, 0, 0};
+    waterEdgeDirty = false;
+    grassDirty = false;
+    propsDirty = false;
+    meshGenerated = false;
+    chunkBounds = HeightBounds{};
+    std::fill(blockBounds.begin(), blockBounds.end(), HeightBounds{});
 }
 
 void tileGrid::setTile(int x, int y, tile tile) {
+    const struct tile& old = grid[x][y];
+    // Grass placement only reads surface data; machine pointers and water do not matter
+    bool surfaceChanged = old.biome != tile.biome ||
+                          old.temperature != tile.temperature ||
+                          old.moisture != tile.moisture ||
+                          old.biologicalPotential != tile.biologicalPotential ||
+                          old.erosionFactor != tile.erosionFactor;
+    for (int i = 0; i < 4 && !surfaceChanged; ++i) {
+        surfaceChanged = old.tileHeight[i] != tile.tileHeight[i];
+    }
+    if (surfaceChanged) grassDirty = true;
+    // Props also avoid water and machines and follow the other potentials
+    if (surfaceChanged || old.occupyingMachine != tile.occupyingMachine ||
+        old.waterLevel != tile.waterLevel || old.riverWidth != tile.riverWidth ||
+        old.magmaticPotential != tile.magmaticPotential ||
+        old.crystalinePotential != tile.crystalinePotential) {
+        propsDirty = true;
+    }
+
     grid[x][y] = tile;
+    markDirty(x, y, x + 1, y + 1);
+
+    // Grow the pick bounds right away so picks stay correct before the next
+    // mesh update; updateDirtyMesh() tightens them again
+    HeightBounds& block = blockBoundsAt(x, y);
+    for (int i = 0; i < 4; ++i) {
+        block.include(tile.tileHeight[i]);
+        chunkBounds.include(tile.tileHeight[i]);
+    }
+}
+
+// Recompute exact height bounds for the blocks overlapping rect, then the chunk
+void tileGrid::rebuildHeightBounds(const TileRect& rect) {
+    for (int by = rect.y0 / PICK_BLOCK; by <= (rect.y1 - 1) / PICK_BLOCK; ++by) {
+        for (int bx = rect.x0 / PICK_BLOCK; bx <= (rect.x1 - 1) / PICK_BLOCK; ++bx) {
+            HeightBounds bounds;
+            for (int y = by * PICK_BLOCK; y < std::min(height, (by + 1) * PICK_BLOCK); ++y) {
+                for (int x = bx * PICK_BLOCK; x < std::min(width, (bx + 1) * PICK_BLOCK); ++x) {
+                    const tile& t = grid[x][y];
+                    if (t.type == AIR) continue;
+                    for (int i = 0; i < 4; ++i) bounds.include(t.tileHeight[i]);
+                }
+            }
+            blockBounds[by * blocksX + bx] = bounds;
+        }
+    }
+    chunkBounds = HeightBounds{};
+    for (const HeightBounds& b : blockBounds) {
+        if (b.minH > b.maxH) continue;  // Empty block
+        chunkBounds.include(b.minH);
+        chunkBounds.include(b.maxH);
+    }
+}
+
+void tileGrid::markDirty(int x0, int y0, int x1, int y1) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    if (dirtyRect.empty()) {
+        dirtyRect = {x0, y0, x1, y1};
+    } else {
+        dirtyRect.x0 = std::min(dirtyRect.x0, x0);
+        dirtyRect.y0 = std::min(dirtyRect.y0, y0);
+        dirtyRect.x1 = std::max(dirtyRect.x1, x1);
+        dirtyRect.y1 = std::max(dirtyRect.y1, y1);
+    }
+}
+
+void tileGrid::setNeighbor(int dir, tileGrid* neighbor) {
+    if (neighborChunks[dir] == neighbor) return;
+    neighborChunks[dir] = neighbor;
+    waterEdgeDirty = true;
+    if (dir == DIR_E) seamDirty[SEAM_EAST] = true;
+    if (dir == DIR_S) seamDirty[SEAM_SOUTH] = true;
+}
+
+// Edits on a border row or column change the walls of the seam on that edge,
+// which may be owned by the west or north neighbour, and the water corners
+// the neighbours share with this chunk
+void tileGrid::markBordersDirty(const TileRect& rect) {
+    if (rect.x1 >= width) seamDirty[SEAM_EAST] = true;
+    if (rect.y1 >= height) seamDirty[SEAM_SOUTH] = true;
+    if (rect.x0 <= 0 && neighborChunks[DIR_W]) neighborChunks[DIR_W]->seamDirty[SEAM_EAST] = true;
+    if (rect.y0 <= 0 && neighborChunks[DIR_N]) neighborChunks[DIR_N]->seamDirty[SEAM_SOUTH] = true;
+
+    int dxMin = rect.x0 <= 0 ? -1 : 0;
+    int dxMax = rect.x1 >= width ? 1 : 0;
+    int dyMin = rect.y0 <= 0 ? -1 : 0;
+    int dyMax = rect.y1 >= height ? 1 : 0;
+    for (int dir = 0; dir < 8; ++dir) {
+        static const int DX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+        static const int DY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+        if (!neighborChunks[dir]) continue;
+        if (DX[dir] < dxMin || DX[dir] > dxMax || DY[dir] < dyMin || DY[dir] > dyMax) continue;
+        neighborChunks[dir]->waterEdgeDirty = true;
+    }
+}
+
+bool tileGrid::consumeGrassDirty() {
+    bool wasDirty = grassDirty;
+    grassDirty = false;
+    return wasDirty;
+}
+
+bool tileGrid::consumePropsDirty() {
+    bool wasDirty = propsDirty;
+    propsDirty = false;
+    return wasDirty;
 }
 
 tile tileGrid::getTile(int x, int y) {
@@ -97,6 +237,8 @@ bool tileGrid::placeMachine(int x, int y, machine* machinePtr) {
     for(machineTileOffset offset : machinePtr->tileOffsets) {
         grid[y + offset.y][x + offset.x].occupyingMachine = machinePtr;
     }
+    // Props do not grow through machines
+    propsDirty = true;
 
     return true;
 }
@@ -124,6 +266,7 @@ void tileGrid::removeMachine(int x, int y) {
             grid[currentY][currentX].occupyingMachine = nullptr;
         }
     }
+    propsDirty = true;
 }
 
 void tileGrid::generatePerlinTerrain(float scale, int heightCo,
@@ -133,37 +276,33 @@ void tileGrid::generatePerlinTerrain(float scale, int heightCo,
     WorldMap& worldMap = WorldMap::getInstance();
     BiomeManager& biomeMan = BiomeManager::getInstance();
 
-    // Preallocate helpers for hydrology
-    const int N = width * height;
-    
-    std::vector<float> groundElev(N, 0.0f);
-    std::vector<uint8_t> moist(N, 0);
-    std::vector<uint8_t> temp(N, 0);
-    std::vector<uint8_t> biol(N, 0);
+    // Per-chunk grids from the WorldMap live on this thread's scratch arena
+    ScratchScope scratch;
+    std::pmr::memory_resource* mem = scratch.resource();
 
     auto idx = [this](int x, int y) { return y * this->width + x; };
 
     // === GET DATA FROM WORLDMAP (handles erosion, caching, etc.) ===
     
     // Get pre-eroded height grid from WorldMap
-    std::vector<float> heightGrid;
+    std::pmr::vector<float> heightGrid(mem);
     worldMap.getHeightGrid(heightGrid, baseGenOffset[0], baseGenOffset[1], width, height);
     
     // Get potentials grid from WorldMap
-    std::vector<PotentialData> potentialsGrid;
+    std::pmr::vector<PotentialData> potentialsGrid(mem);
     worldMap.getPotentialGrid(potentialsGrid, baseGenOffset[0], baseGenOffset[1], width, height);
     
     // Get water levels from WorldMap (computed at region scale)
-    std::vector<float> waterGrid;
+    std::pmr::vector<float> waterGrid(mem);
     worldMap.getWaterGrid(waterGrid, baseGenOffset[0], baseGenOffset[1], width, height);
     
     // Get river data from WorldMap
-    std::vector<uint8_t> flowDirGrid;
-    std::vector<uint8_t> riverWidthGrid;
+    std::pmr::vector<uint8_t> flowDirGrid(mem);
+    std::pmr::vector<uint8_t> riverWidthGrid(mem);
     worldMap.getRiverGrid(flowDirGrid, riverWidthGrid, baseGenOffset[0], baseGenOffset[1], width, height);
     
     // Get erosion intensity data from WorldMap
-    std::vector<uint8_t> erosionGrid;
+    std::pmr::vector<uint8_t> erosionGrid(mem);
     worldMap.getErosionGrid(erosionGrid, baseGenOffset[0], baseGenOffset[1], width, height);
     
     // Height grid indexer (width+1 columns)
@@ -280,11 +419,6 @@ void tileGrid::generatePerlinTerrain(float scale, int heightCo,
             // Assign erosion factor from pre-computed erosion simulation
             t.erosionFactor = erosionGrid[idx(x, y)];
 
-            float avgHeight = (t.tileHeight[0] + t.tileHeight[1] + t.tileHeight[2] + t.tileHeight[3]) / 4.0f;
-            groundElev[idx(x,y)] = avgHeight;
-            moist[idx(x,y)] = t.moisture;
-            temp[idx(x,y)] = t.temperature;
-
             setTile(x, y, t);
         }
     }
@@ -340,40 +474,110 @@ void tileGrid::generatePerlinTerrain(float scale, int heightCo,
 
 // Ray-based tile picking: intersect ray with mesh of tile surfaces
 Vector3 tileGrid::getTileIndexDDA(Ray ray) {
-    Vector3 bestHitPos = { -1, -1, -1 };
-    float minDistance = FLT_MAX;
-    // Iterate over all tiles
-    for (int x = 0; x < width; ++x) {
-        for (int y = 0; y < height; ++y) {
-            tile t = getTile(x, y);
-            // Build tile surface triangles
-            Vector3 v0 = { (float)x,     (float)t.tileHeight[0], (float)y     };
-            Vector3 v1 = { (float)x + 1, (float)t.tileHeight[1], (float)y     };
-            Vector3 v2 = { (float)x + 1, (float)t.tileHeight[2], (float)y + 1 };
-            Vector3 v3 = { (float)x,     (float)t.tileHeight[3], (float)y + 1 };
-            // Check collision for first triangle
-            RayCollision hit = GetRayCollisionTriangle(ray, v0, v1, v2);
-            if (hit.hit && hit.distance < minDistance) {
-                minDistance = hit.distance;
-                bestHitPos = hit.point;
-            }
-            // Check col-   lision for second triangle
-            hit = GetRayCollisionTriangle(ray, v0, v2, v3);
-            if (hit.hit && hit.distance < minDistance) {
-                minDistance = hit.distance;
-                bestHitPos = hit.point;
-            }
+    TileHit hit;
+    if (!raycast(ray, 0.0f, FLT_MAX, hit)) {
+        return Vector3{ -1, -1, -1 };
+    }
+    // Return discrete tile indices (z unused)
+    return Vector3{ (float)hit.x, (float)hit.y, 0.0f };
+}
+
+// Height of a tile's surface at fractional position (fx, fz) inside it, using
+// the same diagonal split as the mesh
+static float tileSurfaceHeight(const tile& t, float fx, float fz) {
+    const float* h = t.tileHeight;
+    if (fabsf(h[0] - h[2]) <= fabsf(h[1] - h[3])) {
+        // Diagonal v0-v2
+        if (fx >= fz) return h[0] + (h[1] - h[0]) * fx + (h[2] - h[1]) * fz;
+        return h[0] + (h[2] - h[3]) * fx + (h[3] - h[0]) * fz;
+    }
+    // Diagonal v1-v3
+    if (fx + fz >= 1.0f) return h[2] + (h[2] - h[3]) * (fx - 1.0f) + (h[2] - h[1]) * (fz - 1.0f);
+    return h[0] + (h[1] - h[0]) * fx + (h[3] - h[0]) * fz;
+}
+
+// Test one tile: its walls (the ray entered the column below the surface)
+// and then its two surface triangles
+bool tileGrid::raycastTile(const Ray& ray, int x, int y, float tEnter, TileHit& hit) {
+    const tile& t = grid[x][y];
+    if (t.type == AIR) return false;
+
+    if (tEnter > 0.0f) {
+        Vector3 p = Vector3Add(ray.position, Vector3Scale(ray.direction, tEnter));
+        float fx = std::clamp(p.x - x, 0.0f, 1.0f);
+        float fz = std::clamp(p.z - y, 0.0f, 1.0f);
+        if (p.y < tileSurfaceHeight(t, fx, fz)) {
+            hit.x = x;
+            hit.y = y;
+            hit.distance = tEnter;
+            hit.point = p;
+            return true;
         }
     }
-    // If we hit a tile, convert world hit position to grid indices
-    if (bestHitPos.x >= 0) {
-        int ix = (int)std::floor(bestHitPos.x);
-        int iy = (int)std::floor(bestHitPos.z);
-        // Return discrete tile indices (z unused)
-        return Vector3{ (float)ix, (float)iy, 0.0f };
+
+    Vector3 v0 = { (float)x,     t.tileHeight[0], (float)y     };
+    Vector3 v1 = { (float)x + 1, t.tileHeight[1], (float)y     };
+    Vector3 v2 = { (float)x + 1, t.tileHeight[2], (float)y + 1 };
+    Vector3 v3 = { (float)x,     t.tileHeight[3], (float)y + 1 };
+    RayCollision a, b;
+    if (fabsf(t.tileHeight[0] - t.tileHeight[2]) <= fabsf(t.tileHeight[1] - t.tileHeight[3])) {
+        a = GetRayCollisionTriangle(ray, v0, v1, v2);
+        b = GetRayCollisionTriangle(ray, v0, v2, v3);
+    } else {
+        a = GetRayCollisionTriangle(ray, v1, v2, v3);
+        b = GetRayCollisionTriangle(ray, v1, v3, v0);
     }
-    // No hit: return original sentinel
-    return bestHitPos;
+    if (!a.hit && !b.hit) return false;
+    const RayCollision& best = (a.hit && (!b.hit || a.distance <= b.distance)) ? a : b;
+    hit.x = x;
+    hit.y = y;
+    hit.distance = best.distance;
+    hit.point = best.point;
+    return true;
+}
+
+bool tileGrid::raycast(const Ray& ray, float tMin, float tMax, TileHit& hit) {
+    if (chunkBounds.minH > chunkBounds.maxH) return false;  // No solid tiles
+
+    // Clip the segment to the chunk footprint
+    const float lo[2] = { 0.0f, 0.0f };
+    const float hi[2] = { (float)width, (float)height };
+    const float origin[2] = { ray.position.x, ray.position.z };
+    const float dir[2] = { ray.direction.x, ray.direction.z };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0.0f) {
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t0 = (lo[axis] - origin[axis]) / dir[axis];
+        float t1 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+    }
+    if (tMin >= tMax) return false;
+    if (!chunkBounds.overlaps(ray, tMin, tMax)) return false;
+
+    GridWalker blocks(ray, (float)PICK_BLOCK, tMin);
+    for (; blocks.t < tMax; blocks.step()) {
+        int bx = blocks.cx;
+        int by = blocks.cy;
+        if (bx < 0 || bx >= blocksX || by < 0 || by >= blocksY) continue;
+
+        float blockExit = std::min(blocks.exitT(), tMax);
+        if (!blockBounds[by * blocksX + bx].overlaps(ray, blocks.t, blockExit)) continue;
+
+        // Walk the tiles of this block
+        GridWalker cells(ray, 1.0f, blocks.t);
+        for (; cells.t < blockExit; cells.step()) {
+            int x = cells.cx;
+            int y = cells.cy;
+            if (x < 0 || x >= width || y < 0 || y >= height) continue;
+            if (x / PICK_BLOCK != bx || y / PICK_BLOCK != by) break;
+            if (raycastTile(ray, x, y, cells.t, hit)) return true;
+        }
+    }
+    return false;
 }
 
 void tileGrid::renderWires() {
@@ -413,253 +617,546 @@ unsigned int tileGrid::getWidth() { return width; }
 unsigned int tileGrid::getHeight() { return height; }
 unsigned int tileGrid::getDepth() { return depth; }
 
-void tileGrid::generateMesh() {
-    // Assuming texture atlas dimensions (you may want to make these configurable)
-    const float atlasWidth = 80.0f;  // Total atlas width in pixels
-    const float atlasHeight = 16.0f; // Total atlas height in pixels
-    
-    std::vector<Vector3> vertices;
-    std::vector<Vector2> texcoords;
-    std::vector<Vector3> normals;
-    std::vector<Color> colors;  // Store erosion data in vertex colors
+// Row slack reserved after each mesh row so that an edited row can usually be
+// re-emitted in place. Two extra walls per terrain row (vertices) and two extra
+// water quads per water row (indices) cover typical single-tile edits.
+static constexpr int TERRAIN_ROW_SLACK = 24;
+static constexpr int WATER_ROW_SLACK = 12;
 
-    for(int x = 0; x < width; x++) {
-        for(int y = 0; y < height; y++) {
-            tile t = getTile(x, y);
-            
-            // Skip air tiles
-            if(t.type == AIR) continue;
-            
-            Vector3 v0 = {(float)x,     (float)t.tileHeight[0], (float)y};
-            Vector3 v1 = {(float)x + 1, (float)t.tileHeight[1], (float)y};
-            Vector3 v2 = {(float)x + 1, (float)t.tileHeight[2], (float)y + 1};
-            Vector3 v3 = {(float)x,     (float)t.tileHeight[3], (float)y + 1};
-            
-            // Choose the mesh diagonal with the smallest height difference for a smoother look
-            float diag1_diff = fabsf(t.tileHeight[0] - t.tileHeight[2]);
-            float diag2_diff = fabsf(t.tileHeight[1] - t.tileHeight[3]);
-
-            // Vertex color encodes terrain data for shader:
-            // R = primary texture type (GRASS=1, SNOW=2, STONE=3, SAND=4)
-            // G = secondary texture type (for blending)
-            // B = blend strength (0=100% primary, 255=100% secondary)
-            // A = erosion factor (0-255)
-            Color tileDataColor = { 
-                static_cast<unsigned char>(t.type),         // Primary texture
-                static_cast<unsigned char>(t.secondaryType),// Secondary texture for blending
-                t.blendStrength,                            // Blend strength
-                t.erosionFactor                             // Erosion for dithering
-            };
-            
-            // Use the tile's primary type for texture coordinates
-            // The shader handles blending to secondary type via dithering
-            textureAtlas texAtlas = textures[t.type];
-            float uMin = (float)texAtlas.uOffset / atlasWidth;
-            float vMin = (float)texAtlas.vOffset / atlasHeight;
-            float uMax = (float)(texAtlas.uOffset + texAtlas.width) / atlasWidth;
-            float vMax = (float)(texAtlas.vOffset + texAtlas.height) / atlasHeight;
-            
-            if (diag1_diff <= diag2_diff) {
-                // --- Split with diagonal v0-v2 ---
-                // Triangle 1: v0, v1, v2
-                vertices.push_back(v0); vertices.push_back(v1); vertices.push_back(v2);
-                texcoords.push_back(Vector2{uMin, vMin}); texcoords.push_back(Vector2{uMax, vMin}); texcoords.push_back(Vector2{uMax, vMax});
-                Vector3 n1_edge1 = Vector3Subtract(v1, v0);
-                Vector3 n1_edge2 = Vector3Subtract(v2, v0);
-                Vector3 normal1 = Vector3Normalize(Vector3CrossProduct(n1_edge1, n1_edge2));
-                normals.push_back(normal1); normals.push_back(normal1); normals.push_back(normal1);
-                colors.push_back(tileDataColor); colors.push_back(tileDataColor); colors.push_back(tileDataColor);
-                
-                // Triangle 2: v0, v2, v3
-                vertices.push_back(v0); vertices.push_back(v2); vertices.push_back(v3);
-                texcoords.push_back(Vector2{uMin, vMin}); texcoords.push_back(Vector2{uMax, vMax}); texcoords.push_back(Vector2{uMin, vMax});
-                Vector3 n2_edge1 = Vector3Subtract(v2, v0);
-                Vector3 n2_edge2 = Vector3Subtract(v3, v0);
-                Vector3 normal2 = Vector3Normalize(Vector3CrossProduct(n2_edge1, n2_edge2));
-                normals.push_back(normal2); normals.push_back(normal2); normals.push_back(normal2);
-                colors.push_back(tileDataColor); colors.push_back(tileDataColor); colors.push_back(tileDataColor);
+// Top-face normals depend only on the triangle's height gradients (gx, gz):
+// every split of a tile yields normalize(gx, -1, gz). Heights sit on quarter
+// units and slopes are clamped, so the gradients are small integers in quarter
+// units and the normal can be read from a table built once.
+static constexpr int NORMAL_TABLE_RANGE = 32;  // +-8 height units in quarter steps
+static constexpr int NORMAL_TABLE_SIZE = 2 * NORMAL_TABLE_RANGE + 1;
 
-            } else {
-                // --- Split with diagonal v1-v3 ---
-                // Triangle 1: v1, v2, v3
-                vertices.push_back(v1); vertices.push_back(v2); vertices.push_back(v3);
-                texcoords.push_back(Vector2{uMax, vMin}); texcoords.push_back(Vector2{uMax, vMax}); texcoords.push_back(Vector2{uMin, vMax});
-                Vector3 n1_edge1 = Vector3Subtract(v2, v1);
-                Vector3 n1_edge2 = Vector3Subtract(v3, v1);
-                Vector3 normal1 = Vector3Normalize(Vector3CrossProduct(n1_edge1, n1_edge2));
-                normals.push_back(normal1); normals.push_back(normal1); normals.push_back(normal1);
-                colors.push_back(tileDataColor); colors.push_back(tileDataColor); colors.push_back(tileDataColor);
-
-                // Triangle 2: v1, v3, v0
-                vertices.push_back(v1); vertices.push_back(v3); vertices.push_back(v0);
-                texcoords.push_back(Vector2{uMax, vMin}); texcoords.push_back(Vector2{uMin, vMax}); texcoords.push_back(Vector2{uMin, vMin});
-                Vector3 n2_edge1 = Vector3Subtract(v3, v1);
-                Vector3 n2_edge2 = Vector3Subtract(v0, v1);
-                Vector3 normal2 = Vector3Normalize(Vector3CrossProduct(n2_edge1, n2_edge2));
-                normals.push_back(normal2); normals.push_back(normal2); normals.push_back(normal2);
-                colors.push_back(tileDataColor); colors.push_back(tileDataColor); colors.push_back(tileDataColor);
-            }
-            
-            // Generate side faces (walls) where there are height differences
-            // Calculate UV coordinates for side faces
-            float sideUMin = (float)textures[t.type].sideUOffset / atlasWidth;
-            float sideVMin = (float)textures[t.type].sideVOffset / atlasHeight;
-            float sideUMax = (float)(textures[t.type].sideUOffset + textures[t.type].width) / atlasWidth;
-            float sideVMax = (float)(textures[t.type].sideVOffset + textures[t.type].height) / atlasHeight;
-            
-            // Walls always show exposed rock texture (full erosion)
-            Color wallColor = { 255, 255, 255, 255 };
-            
-            // Check each edge for height differences and generate wall faces only where needed
-            
-            // Edge 0->1 (front edge) - check neighbor tile at y-1
-            if (y > 0) {
-                tile neighborTile = getTile(x, y - 1);
-                // Create wall if this tile's edge is higher than neighbor's opposite edge
-                if (t.tileHeight[0] > neighborTile.tileHeight[3] || t.tileHeight[1] > neighborTile.tileHeight[2]) {
-                    Vector3 w0 = {(float)x,     (float)neighborTile.tileHeight[3], (float)y};
-                    Vector3 w1 = {(float)x + 1, (float)neighborTile.tileHeight[2], (float)y};
-                    
-                    // Wall face (2 triangles)
-                    vertices.push_back(w1); vertices.push_back(w0); vertices.push_back(v0);
-                    vertices.push_back(v0); vertices.push_back(v1); vertices.push_back(w1);
-                    
-                    // Side texture coordinates
-                    texcoords.push_back(Vector2{sideUMin, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMin});
-                    texcoords.push_back(Vector2{sideUMax, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMax});
-                    
-                    // Wall normal (facing negative Z)
-                    Vector3 wallNormal = {0, 0, 1};
-                    for(int i = 0; i < 6; i++) {
-                        normals.push_back(wallNormal);
-                        colors.push_back(wallColor);
-                    }
-                }
-            }
-            
-            // Edge 1->2 (right edge) - check neighbor tile at x+1
-            if (x < width - 1) {
-                tile neighborTile = getTile(x + 1, y);
-                // Create wall if this tile's edge is higher than neighbor's opposite edge
-                if (t.tileHeight[1] > neighborTile.tileHeight[0] || t.tileHeight[2] > neighborTile.tileHeight[3]) {
-                    Vector3 w1 = {(float)x + 1, (float)neighborTile.tileHeight[0], (float)y};
-                    Vector3 w2 = {(float)x + 1, (float)neighborTile.tileHeight[3], (float)y + 1};
-                    
-                    // Wall face (2 triangles)
-                    vertices.push_back(v1); vertices.push_back(v2); vertices.push_back(w2);
-                    vertices.push_back(w2); vertices.push_back(w1); vertices.push_back(v1);
-
-                    // Side texture coordinates
-                    texcoords.push_back(Vector2{sideUMin, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMax});
-                    texcoords.push_back(Vector2{sideUMax, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMin});
-                    
-                    // Wall normal (facing positive X)
-                    Vector3 wallNormal = {-1, 0, 0};
-                    for(int i = 0; i < 6; i++) {
-                        normals.push_back(wallNormal);
-                        colors.push_back(wallColor);
-                    }
-                }
-            }
-            
-            // Edge 2->3 (back edge) - check neighbor tile at y+1
-            if (y < height - 1) {
-                tile neighborTile = getTile(x, y + 1);
-                // Create wall if this tile's edge is higher than neighbor's opposite edge
-                if (t.tileHeight[2] > neighborTile.tileHeight[1] || t.tileHeight[3] > neighborTile.tileHeight[0]) {
-                    Vector3 w2 = {(float)x + 1, (float)neighborTile.tileHeight[1], (float)y + 1};
-                    Vector3 w3 = {(float)x,     (float)neighborTile.tileHeight[0], (float)y + 1};
-                    
-                    // Wall face (2 triangles)
-                    vertices.push_back(v2); vertices.push_back(v3); vertices.push_back(w3);
-                    vertices.push_back(w3); vertices.push_back(w2); vertices.push_back(v2);
-
-                    // Side texture coordinates
-                    texcoords.push_back(Vector2{sideUMin, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMax});
-                    texcoords.push_back(Vector2{sideUMax, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMin});
-                    
-                    // Wall normal (facing positive Z)
-                    Vector3 wallNormal = {0, 0, -1};
-                    for(int i = 0; i < 6; i++) {
-                        normals.push_back(wallNormal);
-                        colors.push_back(wallColor);
-                    }
-                }
-            }
-            
-            // Edge 3->0 (left edge) - check neighbor tile at x-1
-            if (x > 0) {
-                tile neighborTile = getTile(x - 1, y);
-                // Create wall if this tile's edge is higher than neighbor's opposite edge
-                if (t.tileHeight[3] > neighborTile.tileHeight[2] || t.tileHeight[0] > neighborTile.tileHeight[1]) {
-                    Vector3 w3 = {(float)x, (float)neighborTile.tileHeight[2], (float)y + 1};
-                    Vector3 w0 = {(float)x, (float)neighborTile.tileHeight[1], (float)y};
-                    
-                    // Wall face (2 triangles)
-                    vertices.push_back(v3); vertices.push_back(v0); vertices.push_back(w0);
-                    vertices.push_back(w0); vertices.push_back(w3); vertices.push_back(v3);
-
-                    // Side texture coordinates
-                    texcoords.push_back(Vector2{sideUMin, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMin}); texcoords.push_back(Vector2{sideUMax, sideVMax});
-                    texcoords.push_back(Vector2{sideUMax, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMax}); texcoords.push_back(Vector2{sideUMin, sideVMin});
-                    
-                    // Wall normal (facing negative X)
-                    Vector3 wallNormal = {1, 0, 0};
-                    for(int i = 0; i < 6; i++) {
-                        normals.push_back(wallNormal);
-                        colors.push_back(wallColor);
-                    }
-                }
+std::atomic<bool> tileGrid::useNormalTable{true};
+
+static const std::vector<Vector3>& normalTable() {
+    static const std::vector<Vector3> table = [] {
+        std::vector<Vector3> t(NORMAL_TABLE_SIZE * NORMAL_TABLE_SIZE);
+        for (int iz = 0; iz < NORMAL_TABLE_SIZE; ++iz) {
+            for (int ix = 0; ix < NORMAL_TABLE_SIZE; ++ix) {
+                float gx = (ix - NORMAL_TABLE_RANGE) * 0.25f;
+                float gz = (iz - NORMAL_TABLE_RANGE) * 0.25f;
+                t[iz * NORMAL_TABLE_SIZE + ix] = Vector3Normalize(Vector3{gx, -1.0f, gz});
             }
         }
+        return t;
+    }();
+    return table;
+}
+
+// Normal of a top-face triangle with height gradients gx (along x) and gz (along z)
+static Vector3 surfaceNormal(float gx, float gz, bool useTable) {
+    if (useTable) {
+        float qx = gx * 4.0f;
+        float qz = gz * 4.0f;
+        int ix = (int)qx;
+        int iz = (int)qz;
+        // Off-grid or out-of-range gradients (e.g. hand-edited heights) fall through
+        if ((float)ix == qx && (float)iz == qz &&
+            std::abs(ix) <= NORMAL_TABLE_RANGE && std::abs(iz) <= NORMAL_TABLE_RANGE) {
+            return normalTable()[(iz + NORMAL_TABLE_RANGE) * NORMAL_TABLE_SIZE + (ix + NORMAL_TABLE_RANGE)];
+        }
     }
+    return Vector3Normalize(Vector3{gx, -1.0f, gz});
+}
+
+// UV corner bits of PackedTerrainVertex::corner
+static constexpr uint8_t CORNER_U = 1;
+static constexpr uint8_t CORNER_V = 2;
+
+// How far LOD skirts reach below the chunk's lowest terrain
+static constexpr float LOD_SKIRT_DEPTH = 4.0f;
+
+void tileGrid::TerrainVertices::clear() {
+    vertices.clear();
+}
+
+void tileGrid::TerrainVertices::push(Vector3 position, Vector3 normal, uint8_t atlasCell, uint8_t corner, Color color) {
+    vertices.push_back(PackedTerrainVertex::pack(position, normal, atlasCell, corner, color));
+}
+
+// Emit the top surface and walls of a single tile
+void tileGrid::emitTerrainTile(int x, int y, TerrainVertices& out) {
+    tile t = getTile(x, y);
+    
+    // Skip air tiles
+    if(t.type == AIR) return;
+    
+    Vector3 v0 = {(float)x,     (float)t.tileHeight[0], (float)y};
+    Vector3 v1 = {(float)x + 1, (float)t.tileHeight[1], (float)y};
+    Vector3 v2 = {(float)x + 1, (float)t.tileHeight[2], (float)y + 1};
+    Vector3 v3 = {(float)x,     (float)t.tileHeight[3], (float)y + 1};
     
-    int vertexCount = vertices.size();
-    int triangleCount = vertexCount / 3;
+    // Choose the mesh diagonal with the smallest height difference for a smoother look
+    float diag1_diff = fabsf(t.tileHeight[0] - t.tileHeight[2]);
+    float diag2_diff = fabsf(t.tileHeight[1] - t.tileHeight[3]);
+    const float* h = t.tileHeight;
 
-    // Create mesh structure and allocate memory
-    mesh = {0};
-    mesh.vertexCount = vertexCount;
-    mesh.triangleCount = triangleCount;
+    // Vertex color encodes terrain data for shader:
+    // R = primary texture type (GRASS=1, SNOW=2, STONE=3, SAND=4)
+    // G = secondary texture type (for blending)
+    // B = blend strength (0=100% primary, 255=100% secondary)
+    // A = erosion factor (0-255)
+    Color tileDataColor = { 
+        static_cast<unsigned char>(t.type),         // Primary texture
+        static_cast<unsigned char>(t.secondaryType),// Secondary texture for blending
+        t.blendStrength,                            // Blend strength
+        t.erosionFactor                             // Erosion for dithering
+    };
     
-    // Allocate and copy vertex data
-    mesh.vertices = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
-    mesh.texcoords = (float*)MemAlloc(vertexCount * 2 * sizeof(float));
-    mesh.normals = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
-    mesh.colors = (unsigned char*)MemAlloc(vertexCount * 4 * sizeof(unsigned char));  // RGBA colors for erosion
+    // Use the tile's primary type for the atlas cell
+    // The shader handles blending to secondary type via dithering
+    textureAtlas texAtlas = textures[t.type];
+    uint8_t cell = atlasCellIndex(texAtlas.uOffset, texAtlas.vOffset);
     
-    // Copy vertex data
-    for(int i = 0; i < vertexCount; i++) {
-        mesh.vertices[i * 3 + 0] = vertices[i].x;
-        mesh.vertices[i * 3 + 1] = vertices[i].y;
-        mesh.vertices[i * 3 + 2] = vertices[i].z;
-        
-        mesh.texcoords[i * 2 + 0] = texcoords[i].x;
-        mesh.texcoords[i * 2 + 1] = texcoords[i].y;
+    const bool table = out.normalTable;
+    if (diag1_diff <= diag2_diff) {
+        // --- Split with diagonal v0-v2 ---
+        // Triangle 1: v0, v1, v2
+        Vector3 normal1 = surfaceNormal(h[1] - h[0], h[2] - h[1], table);
+        out.push(v0, normal1, cell, 0, tileDataColor);
+        out.push(v1, normal1, cell, CORNER_U, tileDataColor);
+        out.push(v2, normal1, cell, CORNER_U | CORNER_V, tileDataColor);
         
-        mesh.normals[i * 3 + 0] = normals[i].x;
-        mesh.normals[i * 3 + 1] = normals[i].y;
-        mesh.normals[i * 3 + 2] = normals[i].z;
-        
-        // Copy color (RGBA)
-        mesh.colors[i * 4 + 0] = colors[i].r;
-        mesh.colors[i * 4 + 1] = colors[i].g;
-        mesh.colors[i * 4 + 2] = colors[i].b;
-        mesh.colors[i * 4 + 3] = colors[i].a;  // Erosion in alpha
+        // Triangle 2: v0, v2, v3
+        Vector3 normal2 = surfaceNormal(h[2] - h[3], h[3] - h[0], table);
+        out.push(v0, normal2, cell, 0, tileDataColor);
+        out.push(v2, normal2, cell, CORNER_U | CORNER_V, tileDataColor);
+        out.push(v3, normal2, cell, CORNER_V, tileDataColor);
+
+    } else {
+        // --- Split with diagonal v1-v3 ---
+        // Triangle 1: v1, v2, v3
+        Vector3 normal1 = surfaceNormal(h[2] - h[3], h[2] - h[1], table);
+        out.push(v1, normal1, cell, CORNER_U, tileDataColor);
+        out.push(v2, normal1, cell, CORNER_U | CORNER_V, tileDataColor);
+        out.push(v3, normal1, cell, CORNER_V, tileDataColor);
+
+        // Triangle 2: v1, v3, v0
+        Vector3 normal2 = surfaceNormal(h[1] - h[0], h[3] - h[0], table);
+        out.push(v1, normal2, cell, CORNER_U, tileDataColor);
+        out.push(v3, normal2, cell, CORNER_V, tileDataColor);
+        out.push(v0, normal2, cell, 0, tileDataColor);
     }
     
-    UploadMesh(&mesh, true);
-    
-    // Create model from mesh and assign diffuse texture
-    model = LoadModelFromMesh(mesh);
-    model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = resourceManager::terrainTexture;
-    // Assign shared terrain shader
-    Shader& shader = resourceManager::getShader(0);
-    model.materials[0].shader = shader;
-    
+    // Walls on interior edges; border edges are emitted by the seam meshes
+    if (y > 0)          emitWall(0, t, getTile(x, y - 1), x, y, out);
+    if (x < width - 1)  emitWall(1, t, getTile(x + 1, y), x, y, out);
+    if (y < height - 1) emitWall(2, t, getTile(x, y + 1), x, y, out);
+    if (x > 0)          emitWall(3, t, getTile(x - 1, y), x, y, out);
+}
+
+// Emit the wall below one edge of tile t (placed at x, y) where it stands higher
+// than the opposite edge of neighbour n.
+// Edges: 0 = front (y-1), 1 = right (x+1), 2 = back (y+1), 3 = left (x-1)
+void tileGrid::emitWall(int edge, const tile& t, const tile& n, int x, int y, TerrainVertices& out) {
+    Vector3 v0 = {(float)x,     (float)t.tileHeight[0], (float)y};
+    Vector3 v1 = {(float)x + 1, (float)t.tileHeight[1], (float)y};
+    Vector3 v2 = {(float)x + 1, (float)t.tileHeight[2], (float)y + 1};
+    Vector3 v3 = {(float)x,     (float)t.tileHeight[3], (float)y + 1};
+
+    // Side faces use the tile's side texture cell
+    uint8_t cell = atlasCellIndex(textures[t.type].sideUOffset, textures[t.type].sideVOffset);
+
+    // Walls always show exposed rock texture (full erosion)
+    Color wallColor = { 255, 255, 255, 255 };
+
+    // Wall face (2 triangles), UV corners in the same order as the vertices
+    auto addQuad = [&](Vector3 a, Vector3 b, Vector3 c, Vector3 d, uint8_t ca, uint8_t cb, uint8_t cc, uint8_t cd, Vector3 wallNormal) {
+        out.push(a, wallNormal, cell, ca, wallColor);
+        out.push(b, wallNormal, cell, cb, wallColor);
+        out.push(c, wallNormal, cell, cc, wallColor);
+        out.push(c, wallNormal, cell, cc, wallColor);
+        out.push(d, wallNormal, cell, cd, wallColor);
+        out.push(a, wallNormal, cell, ca, wallColor);
+    };
+    const uint8_t UV00 = 0, UV10 = CORNER_U, UV11 = CORNER_U | CORNER_V, UV01 = CORNER_V;
+
+    switch (edge) {
+    case 0: {
+        // Front edge - create wall if this tile's edge is higher than neighbor's opposite edge
+        if (!(t.tileHeight[0] > n.tileHeight[3] || t.tileHeight[1] > n.tileHeight[2])) return;
+        Vector3 w0 = {(float)x,     (float)n.tileHeight[3], (float)y};
+        Vector3 w1 = {(float)x + 1, (float)n.tileHeight[2], (float)y};
+        // Wall normal (facing negative Z)
+        addQuad(w1, w0, v0, v1, UV01, UV00, UV10, UV11, Vector3{0, 0, 1});
+        break;
+    }
+    case 1: {
+        // Right edge
+        if (!(t.tileHeight[1] > n.tileHeight[0] || t.tileHeight[2] > n.tileHeight[3])) return;
+        Vector3 w1 = {(float)x + 1, (float)n.tileHeight[0], (float)y};
+        Vector3 w2 = {(float)x + 1, (float)n.tileHeight[3], (float)y + 1};
+        // Wall normal (facing positive X)
+        addQuad(v1, v2, w2, w1, UV00, UV10, UV11, UV01, Vector3{-1, 0, 0});
+        break;
+    }
+    case 2: {
+        // Back edge
+        if (!(t.tileHeight[2] > n.tileHeight[1] || t.tileHeight[3] > n.tileHeight[0])) return;
+        Vector3 w2 = {(float)x + 1, (float)n.tileHeight[1], (float)y + 1};
+        Vector3 w3 = {(float)x,     (float)n.tileHeight[0], (float)y + 1};
+        // Wall normal (facing positive Z)
+        addQuad(v2, v3, w3, w2, UV00, UV10, UV11, UV01, Vector3{0, 0, -1});
+        break;
+    }
+    default: {
+        // Left edge
+        if (!(t.tileHeight[3] > n.tileHeight[2] || t.tileHeight[0] > n.tileHeight[1])) return;
+        Vector3 w3 = {(float)x, (float)n.tileHeight[2], (float)y + 1};
+        Vector3 w0 = {(float)x, (float)n.tileHeight[1], (float)y};
+        // Wall normal (facing negative X)
+        addQuad(v3, v0, w0, w3, UV00, UV10, UV11, UV01, Vector3{1, 0, 0});
+        break;
+    }
+    }
+}
+
+void tileGrid::emitTerrainRow(int y, TerrainVertices& out) {
+    for (int x = 0; x < width; x++) {
+        emitTerrainTile(x, y, out);
+    }
+}
+
+// Append a row to a vertex stream, padding the remaining capacity with
+// degenerate (zero-area) triangles
+void tileGrid::writeTerrainRow(const MeshRowSpan& span, const TerrainVertices& row,
+                               std::vector<PackedTerrainVertex>& out) {
+    out.insert(out.end(), row.vertices.begin(), row.vertices.end());
+    out.resize(out.size() + (span.capacity - row.vertices.size()), PackedTerrainVertex{});
+}
+
+void tileGrid::generateMesh() {
+    TerrainMeshData data;
+    buildMeshData(data);
+    uploadMesh(std::move(data));
+}
+
+void tileGrid::buildMeshData(TerrainMeshData& out) {
+    PROFILE_SCOPE("tileGrid::buildMeshData");
+    // A full rebuild covers any pending edits
+    rebuildHeightBounds({0, 0, width, height});
+    dirtyRect = {0, 0, 0, 0};
+
+    // One normal path for the whole build, even if the toggle flips meanwhile
+    const bool normalTable = useNormalTable.load(std::memory_order_relaxed);
+
+    // Emit rows separately so each row owns a fixed vertex range
+    ScratchScope scratch;
+    std::pmr::vector<TerrainVertices> rows(scratch.resource());
+    rows.reserve(height);
+    for (int y = 0; y < height; y++) {
+        rows.emplace_back(scratch.resource());
+        rows.back().normalTable = normalTable;
+    }
+    out.rows.assign(height, MeshRowSpan{});
+    int vertexCount = 0;
+    {
+        PROFILE_SCOPE("tileGrid::emitTerrain (pack)");
+        for (int y = 0; y < height; y++) {
+            emitTerrainRow(y, rows[y]);
+            MeshRowSpan& span = out.rows[y];
+            span.offset = vertexCount;
+            span.count = (int)rows[y].vertices.size();
+            span.capacity = span.count + TERRAIN_ROW_SLACK;
+            vertexCount += span.capacity;
+        }
+    }
+
+    out.vertices.clear();
+    out.vertices.reserve(vertexCount);
+    for (int y = 0; y < height; y++) {
+        writeTerrainRow(out.rows[y], rows[y], out.vertices);
+    }
+
+    for (int level = 1; level < TERRAIN_LOD_LEVELS; ++level) {
+        buildLodMesh(level, out.lods[level - 1], normalTable);
+    }
+}
+
+void tileGrid::uploadMesh(TerrainMeshData&& data) {
+    PROFILE_SCOPE("tileGrid::uploadMesh");
+    // Border walls live in the seams, which may belong to a neighbour
+    markBordersDirty({0, 0, width, height});
+
+    terrainMesh.upload(data.vertices.data(), (int)data.vertices.size());
+    uploadLodMeshes(data);
+    // Swap so the built data keeps the old row array for the next build
+    std::swap(terrainRows, data.rows);
+
     meshGenerated = true;
 }
 
+// Re-emit terrain rows [rowBegin, rowEnd) into their existing ranges.
+// Returns false if any row no longer fits, leaving a full rebuild to the caller.
+bool tileGrid::patchTerrainRows(int rowBegin, int rowEnd, bool normalTable) {
+    std::vector<PackedTerrainVertex> patch;
+    TerrainVertices row;
+    row.normalTable = normalTable;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        row.clear();
+        emitTerrainRow(y, row);
+        MeshRowSpan& span = terrainRows[y];
+        if ((int)row.vertices.size() > span.capacity) return false;
+        writeTerrainRow(span, row, patch);
+        span.count = (int)row.vertices.size();
+    }
+
+    // Rows are contiguous, so the whole patch is one sub-range upload
+    terrainMesh.update(terrainRows[rowBegin].offset, patch.data(), (int)patch.size());
+    return true;
+}
+
+void tileGrid::updateDirtyMesh() {
+    PROFILE_SCOPE("tileGrid::updateDirtyMesh");
+    // Edits made before the first upload stay queued until the mesh exists
+    if (!dirtyRect.empty() && meshGenerated) {
+        TileRect rect = dirtyRect;
+        dirtyRect = {0, 0, 0, 0};
+        markBordersDirty(rect);
+        rebuildHeightBounds(rect);
+
+        // Walls and water corners read the adjacent rows, so widen by one row each way
+        int rowBegin = std::max(0, rect.y0 - 1);
+        int rowEnd = std::min(height, rect.y1 + 1);
+
+        const bool normalTable = useNormalTable.load(std::memory_order_relaxed);
+        if (!patchTerrainRows(rowBegin, rowEnd, normalTable)) {
+            PROFILE_COUNT("tileGrid full rebuilds (terrain)", 1);
+            generateMesh();
+        } else {
+            // The coarse meshes are a few thousand vertices; rebuild them whole
+            TerrainMeshData lods;
+            for (int level = 1; level < TERRAIN_LOD_LEVELS; ++level) {
+                buildLodMesh(level, lods.lods[level - 1], normalTable);
+            }
+            uploadLodMeshes(lods);
+        }
+        if (!patchWaterRows(rowBegin, rowEnd)) {
+            PROFILE_COUNT("tileGrid full rebuilds (water)", 1);
+            generateWaterMesh();
+        }
+    }
+
+    // A neighbour was linked or edited along the border: refresh the water
+    // corners it shares with this chunk (dry chunks have none)
+    if (waterEdgeDirty && meshGenerated) {
+        waterEdgeDirty = false;
+        if (waterModelLoaded && !patchWaterRows(0, height)) {
+            generateWaterMesh();
+        }
+    }
+
+    for (int s = 0; s < SEAM_COUNT; ++s) {
+        if (seamDirty[s]) generateSeamMesh(s);
+    }
+}
+
+// Build the wall strip between this chunk and its east or south neighbour.
+// Both sides' walls are emitted, so the neighbour never has to rebuild.
+void tileGrid::generateSeamMesh(int seam) {
+    seamDirty[seam] = false;
+
+    tileGrid* other = neighborChunks[seam == SEAM_EAST ? DIR_E : DIR_S];
+    if (!other) {
+        seamMeshes[seam].clear();
+        return;
+    }
+    PROFILE_SCOPE("tileGrid::generateSeamMesh");
+
+    ScratchScope scratch;
+    TerrainVertices strip(scratch.resource());
+    if (seam == SEAM_EAST) {
+        for (int y = 0; y < height; ++y) {
+            tile t = getTile(width - 1, y);
+            tile n = other->getTile(0, y);
+            if (t.type != AIR) emitWall(1, t, n, width - 1, y, strip);
+            if (n.type != AIR) emitWall(3, n, t, width, y, strip);
+        }
+    } else {
+        for (int x = 0; x < width; ++x) {
+            tile t = getTile(x, height - 1);
+            tile n = other->getTile(x, 0);
+            if (t.type != AIR) emitWall(2, t, n, x, height - 1, strip);
+            if (n.type != AIR) emitWall(0, n, t, x, height, strip);
+        }
+    }
+    // Refilled in place whenever either side of the seam changes
+    seamMeshes[seam].upload(strip.vertices.data(), (int)strip.vertices.size());
+}
+
+size_t tileGrid::getTerrainGpuBytes() const {
+    size_t bytes = terrainMesh.getGpuBytes();
+    for (int s = 0; s < SEAM_COUNT; ++s) bytes += seamMeshes[s].getGpuBytes();
+    for (const TerrainMesh& lod : lodMeshes) bytes += lod.getGpuBytes();
+    return bytes;
+}
+
+size_t tileGrid::getTerrainVertexCount() const {
+    size_t count = terrainMesh.getVertexCount();
+    for (int s = 0; s < SEAM_COUNT; ++s) count += seamMeshes[s].getVertexCount();
+    for (const TerrainMesh& lod : lodMeshes) count += lod.getVertexCount();
+    return count;
+}
+
+void tileGrid::markTerrain(int lod, uint32_t frame) const {
+    if (lod > 0 && lodMeshes[lod - 1].isLoaded()) {
+        lodMeshes[lod - 1].mark(frame);
+        return;
+    }
+    terrainMesh.mark(frame);
+    for (int s = 0; s < SEAM_COUNT; ++s) {
+        seamMeshes[s].mark(frame);
+    }
+}
+
+void tileGrid::setPlacement(int originX, int originZ) {
+    const int size = TerrainArenas::REGION_SIZE;
+    int regionX = (int)std::floor((float)originX / size);
+    int regionY = (int)std::floor((float)originZ / size);
+    int localX = originX - regionX * size;
+    int localZ = originZ - regionY * size;
+    terrainMesh.setPlacement(regionX, regionY, 0, localX, localZ);
+    for (TerrainMesh& seam : seamMeshes) seam.setPlacement(regionX, regionY, 0, localX, localZ);
+    for (int level = 1; level < TERRAIN_LOD_LEVELS; ++level) {
+        lodMeshes[level - 1].setPlacement(regionX, regionY, level, localX, localZ);
+    }
+}
+
+int tileGrid::getLodVertexCount(int lod) const {
+    if (lod > 0 && lodMeshes[lod - 1].isLoaded()) return lodMeshes[lod - 1].getVertexCount();
+    int count = terrainMesh.getVertexCount();
+    for (int s = 0; s < SEAM_COUNT; ++s) count += seamMeshes[s].getVertexCount();
+    return count;
+}
+
+float tileGrid::lodCornerHeight(int x, int y) const {
+    float sum = 0.0f;
+    int count = 0;
+    // Corner order TL, TR, BR, BL: the tile to the lower right of the point
+    // meets it with corner 0, and so on around the point
+    if (x < width && y < height) { sum += grid[x][y].tileHeight[0]; count++; }
+    if (x > 0 && y < height)     { sum += grid[x - 1][y].tileHeight[1]; count++; }
+    if (x > 0 && y > 0)          { sum += grid[x - 1][y - 1].tileHeight[2]; count++; }
+    if (x < width && y > 0)      { sum += grid[x][y - 1].tileHeight[3]; count++; }
+    return count > 0 ? sum / count : 0.0f;
+}
+
+// One quad per (1 << level)^2 tiles, textured from the cell's centre tile, plus
+// skirts hanging below every border edge. Walls between terraces become slopes.
+void tileGrid::buildLodMesh(int level, std::vector<PackedTerrainVertex>& out, bool normalTable) const {
+    out.clear();
+    const int step = 1 << level;
+    const int cellsX = width / step;
+    const int cellsY = height / step;
+    if (cellsX == 0 || cellsY == 0) return;
+
+    const int pointsX = cellsX + 1;
+    ScratchScope scratch;
+    std::pmr::vector<float> heights(pointsX * (cellsY + 1), scratch.resource());
+    for (int cy = 0; cy <= cellsY; ++cy) {
+        for (int cx = 0; cx < pointsX; ++cx) {
+            heights[cy * pointsX + cx] = lodCornerHeight(std::min(cx * step, width), std::min(cy * step, height));
+        }
+    }
+    auto pointAt = [&](int cx, int cy) {
+        return Vector3{(float)(cx * step), heights[cy * pointsX + cx], (float)(cy * step)};
+    };
+
+    TerrainVertices mesh(scratch.resource());
+    const float inv = 1.0f / step;
+    for (int cy = 0; cy < cellsY; ++cy) {
+        for (int cx = 0; cx < cellsX; ++cx) {
+            const tile& t = grid[std::min(cx * step + step / 2, width - 1)][std::min(cy * step + step / 2, height - 1)];
+            if (t.type == AIR) continue;
+
+            Vector3 v0 = pointAt(cx, cy);
+            Vector3 v1 = pointAt(cx + 1, cy);
+            Vector3 v2 = pointAt(cx + 1, cy + 1);
+            Vector3 v3 = pointAt(cx, cy + 1);
+            const float h[4] = {v0.y, v1.y, v2.y, v3.y};
+            Color tileDataColor = {static_cast<unsigned char>(t.type), static_cast<unsigned char>(t.secondaryType),
+                                   t.blendStrength, t.erosionFactor};
+            uint8_t cell = atlasCellIndex(textures[t.type].uOffset, textures[t.type].vOffset);
+
+            // Same diagonal choice and gradients as emitTerrainTile, over a wider cell
+            if (fabsf(h[0] - h[2]) <= fabsf(h[1] - h[3])) {
+                Vector3 normal1 = surfaceNormal((h[1] - h[0]) * inv, (h[2] - h[1]) * inv, normalTable);
+                mesh.push(v0, normal1, cell, 0, tileDataColor);
+                mesh.push(v1, normal1, cell, CORNER_U, tileDataColor);
+                mesh.push(v2, normal1, cell, CORNER_U | CORNER_V, tileDataColor);
+                Vector3 normal2 = surfaceNormal((h[2] - h[3]) * inv, (h[3] - h[0]) * inv, normalTable);
+                mesh.push(v0, normal2, cell, 0, tileDataColor);
+                mesh.push(v2, normal2, cell, CORNER_U | CORNER_V, tileDataColor);
+                mesh.push(v3, normal2, cell, CORNER_V, tileDataColor);
+            } else {
+                Vector3 normal1 = surfaceNormal((h[2] - h[3]) * inv, (h[2] - h[1]) * inv, normalTable);
+                mesh.push(v1, normal1, cell, CORNER_U, tileDataColor);
+                mesh.push(v2, normal1, cell, CORNER_U | CORNER_V, tileDataColor);
+                mesh.push(v3, normal1, cell, CORNER_V, tileDataColor);
+                Vector3 normal2 = surfaceNormal((h[1] - h[0]) * inv, (h[3] - h[0]) * inv, normalTable);
+                mesh.push(v1, normal2, cell, CORNER_U, tileDataColor);
+                mesh.push(v3, normal2, cell, CORNER_V, tileDataColor);
+                mesh.push(v0, normal2, cell, 0, tileDataColor);
+            }
+        }
+    }
+
+    // Skirts: outward-facing walls from each border edge down past the lowest
+    // terrain, wound and lit like emitWall's walls facing the same way
+    const float bottom = (chunkBounds.minH <= chunkBounds.maxH ? chunkBounds.minH : 0.0f) - LOD_SKIRT_DEPTH;
+    const Color wallColor = {255, 255, 255, 255};
+    auto skirt = [&](Vector3 a, Vector3 b, Vector3 normal) {
+        const tile& t = grid[std::min((int)std::min(a.x, b.x), width - 1)][std::min((int)std::min(a.z, b.z), height - 1)];
+        uint8_t cell = atlasCellIndex(textures[t.type].sideUOffset, textures[t.type].sideVOffset);
+        Vector3 c = {b.x, bottom, b.z};
+        Vector3 d = {a.x, bottom, a.z};
+        mesh.push(a, normal, cell, 0, wallColor);
+        mesh.push(b, normal, cell, CORNER_U, wallColor);
+        mesh.push(c, normal, cell, CORNER_U | CORNER_V, wallColor);
+        mesh.push(c, normal, cell, CORNER_U | CORNER_V, wallColor);
+        mesh.push(d, normal, cell, CORNER_V, wallColor);
+        mesh.push(a, normal, cell, 0, wallColor);
+    };
+    for (int cx = 0; cx < cellsX; ++cx) {
+        skirt(pointAt(cx, 0), pointAt(cx + 1, 0), Vector3{0, 0, 1});                      // Front (-Z)
+        skirt(pointAt(cx + 1, cellsY), pointAt(cx, cellsY), Vector3{0, 0, -1});           // Back (+Z)
+    }
+    for (int cy = 0; cy < cellsY; ++cy) {
+        skirt(pointAt(cellsX, cy), pointAt(cellsX, cy + 1), Vector3{-1, 0, 0});           // Right (+X)
+        skirt(pointAt(0, cy + 1), pointAt(0, cy), Vector3{1, 0, 0});                      // Left (-X)
+    }
+    // out keeps its capacity across builds
+    out.assign(mesh.vertices.begin(), mesh.vertices.end());
+}
+
+void tileGrid::uploadLodMeshes(const TerrainMeshData& data) {
+    for (int level = 1; level < TERRAIN_LOD_LEVELS; ++level) {
+        // Edits rebuild and refill the whole level
+        const std::vector<PackedTerrainVertex>& vertices = data.lods[level - 1];
+        lodMeshes[level - 1].upload(vertices.data(), (int)vertices.size());
+    }
+}
+
+// Time emitting and packing every terrain row (CPU only, nothing is uploaded)
+double tileGrid::benchmarkPacking(int iterations, bool normalTable) {
+    if (iterations <= 0) return 0.0;
+    TerrainVertices row;
+    row.normalTable = normalTable;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (int y = 0; y < height; ++y) {
+            row.clear();
+            emitTerrainRow(y, row);
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
 void tileGrid::updateLighting(Vector3 sunDirection, Vector3 sunColor, float ambientStrength, Vector3 ambientColor, float shiftIntensity, float shiftDisplacement) {
     // Forward to shared shader uniform updater
     resourceManager::updateTerrainLighting(
@@ -669,128 +1166,215 @@ void tileGrid::updateLighting(Vector3 sunDirection, Vector3 sunColor, float ambi
     );
 }
 
-// Build a separate flat translucent water surface model
-// Rivers and lakes use full tile quads - the carved terrain provides the banks
-void tileGrid::generateWaterMesh() {
-    std::vector<Vector3> vertices;
-    std::vector<Vector3> normals;
-    std::vector<float> baseHeights;
-    std::vector<float> flowDirs;
-    vertices.reserve(width * height * 6);
-    normals.reserve(width * height * 6);
-    baseHeights.reserve(width * height * 6);
-    flowDirs.reserve(width * height * 6);
-
-    const Vector3 upNormal = {0, 1, 0};
-    
-    // Lambda to add a triangle with consistent data
-    auto addTri = [&](Vector3 a, Vector3 b, Vector3 c, float terrainH, float flowDir) {
-        vertices.push_back(a);
-        vertices.push_back(b);
-        vertices.push_back(c);
-        normals.push_back(upNormal);
-        normals.push_back(upNormal);
-        normals.push_back(upNormal);
-        baseHeights.push_back(terrainH);
-        baseHeights.push_back(terrainH);
-        baseHeights.push_back(terrainH);
-        flowDirs.push_back(flowDir);
-        flowDirs.push_back(flowDir);
-        flowDirs.push_back(flowDir);
-    };
-    
-    // Helper to get water height at a tile
-    auto getWaterHeight = [this](int x, int y) -> float {
-        if (x < 0 || x >= width || y < 0 || y >= height) return -1000.0f;
-        tile t = getTile(x, y);
-        if (t.waterLevel > 0) return 0.5f * t.waterLevel + 0.1f;
-        if (t.riverWidth > 0) {
-            // Rivers: water sits in carved channel, slightly above ground
-            float minH = t.tileHeight[0];
-            for (int i = 1; i < 4; i++) minH = std::min(minH, t.tileHeight[i]);
-            return minH + 0.25f;  // Higher water level for visibility
-        }
-        return -1000.0f;
-    };
-    
-    // Process each tile
-    for (int x = 0; x < width; ++x) {
-        for (int y = 0; y < height; ++y) {
-            tile t = getTile(x, y);
-            
-            // Skip if no water at all
-            if (t.waterLevel == 0 && t.riverWidth == 0) continue;
-            
-            // Calculate water height for this tile
-            float waterY;
-            if (t.waterLevel > 0) {
-                waterY = 0.5f * t.waterLevel + 0.1f;
+const tile* tileGrid::borderTile(int x, int y) const {
+    int dx = x < 0 ? -1 : (x >= width ? 1 : 0);
+    int dy = y < 0 ? -1 : (y >= height ? 1 : 0);
+    if (dx == 0 && dy == 0) return &grid[x][y];
+
+    // D8 index by (dy + 1) * 3 + (dx + 1); the centre entry is unused
+    static const int DIR_BY_OFFSET[9] = {DIR_NW, DIR_N, DIR_NE, DIR_W, -1, DIR_E, DIR_SW, DIR_S, DIR_SE};
+    const tileGrid* n = neighborChunks[DIR_BY_OFFSET[(dy + 1) * 3 + (dx + 1)]];
+    if (!n) return nullptr;
+    return &n->grid[x - dx * width][y - dy * height];
+}
+
+// Fill the water cells of tile rows [rowBegin, rowEnd), including the padding
+// columns on either side. Rows -1 and height are the padding rows.
+void tileGrid::buildWaterCells(int rowBegin, int rowEnd) {
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        for (int x = -1; x <= width; ++x) {
+            WaterCell& cell = waterCellAt(x, y);
+            cell = WaterCell{};
+            const tile* t = borderTile(x, y);
+            if (!t) continue;
+
+            float minH = t->tileHeight[0];
+            for (int i = 1; i < 4; i++) minH = std::min(minH, t->tileHeight[i]);
+
+            if (t->waterLevel > 0) {
+                cell.surface = 0.5f * t->waterLevel + 0.1f;
+            } else if (t->riverWidth > 0) {
+                // Rivers: water sits in carved channel, slightly above ground
+                cell.surface = minH + 0.25f;  // Higher water level for visibility
             } else {
-                // River: use terrain-following water at higher level
-                float minH = t.tileHeight[0];
-                for (int i = 1; i < 4; i++) minH = std::min(minH, t.tileHeight[i]);
-                waterY = minH + 0.25f;  // Match getWaterHeight
+                continue;
             }
-            
-            // Get flow direction as angle (0-7 maps to 0-2π)
-            float flowAngle = (t.flowDir < 8) ? (t.flowDir * 0.785398f) : 0.0f;
-            
-            // Average terrain height for depth calculation
-            float avgTerrainH = (t.tileHeight[0] + t.tileHeight[1] + t.tileHeight[2] + t.tileHeight[3]) / 4.0f;
-            
-            float fx = (float)x;
-            float fy = (float)y;
-            
-            // Get water heights at neighboring tiles for corner interpolation
-            float hN = getWaterHeight(x, y-1);
-            float hS = getWaterHeight(x, y+1);
-            float hE = getWaterHeight(x+1, y);
-            float hW = getWaterHeight(x-1, y);
-            float hNE = getWaterHeight(x+1, y-1);
-            float hNW = getWaterHeight(x-1, y-1);
-            float hSE = getWaterHeight(x+1, y+1);
-            float hSW = getWaterHeight(x-1, y+1);
-            
-            // Calculate corner heights - average with valid neighbors for smooth transitions
-            auto cornerHeight = [&](float h1, float h2, float h3) -> float {
-                float sum = waterY;
-                int count = 1;
-                if (h1 > -500.0f) { sum += h1; count++; }
-                if (h2 > -500.0f) { sum += h2; count++; }
-                if (h3 > -500.0f) { sum += h3; count++; }
-                return sum / count;
-            };
-            
-            // Corner layout:  0--1  (NW--NE)  z=y
-            //                 |  |
-            //                 3--2  (SW--SE)  z=y+1
-            float h0 = cornerHeight(hN, hW, hNW);
-            float h1 = cornerHeight(hN, hE, hNE);
-            float h2 = cornerHeight(hS, hE, hSE);
-            float h3 = cornerHeight(hS, hW, hSW);
-            
-            Vector3 corners[4] = {
-                {fx,     h0, fy},
-                {fx + 1, h1, fy},
-                {fx + 1, h2, fy + 1},
-                {fx,     h3, fy + 1}
+            cell.ground = (t->tileHeight[0] + t->tileHeight[1] + t->tileHeight[2] + t->tileHeight[3]) / 4.0f;
+            cell.flowDir = t->flowDir;
+        }
+    }
+}
+
+// Write the water vertices of corner rows [cornerBegin, cornerEnd). The water
+// mesh has one vertex per tile corner, shared by up to four water tiles; its
+// height is the average surface of the wet tiles around it (the same value
+// each tile used to compute for itself), smoothing transitions between tiles.
+void tileGrid::writeWaterCorners(WaterMeshData& out, int cornerBegin, int cornerEnd) {
+    const float twoPi = 6.283185f;
+    for (int cy = cornerBegin; cy < cornerEnd; ++cy) {
+        for (int cx = 0; cx <= width; ++cx) {
+            const WaterCell* around[4] = {
+                &waterCellAt(cx - 1, cy - 1), &waterCellAt(cx, cy - 1),
+                &waterCellAt(cx - 1, cy),     &waterCellAt(cx, cy)
             };
-            
-            // Draw full quad as two triangles
-            addTri(corners[2], corners[1], corners[0], avgTerrainH, flowAngle);
-            addTri(corners[0], corners[3], corners[2], avgTerrainH, flowAngle);
+
+            float surface = 0.0f;
+            float ground = 0.0f;
+            float flowX = 0.0f;
+            float flowZ = 0.0f;
+            int wet = 0;
+            for (const WaterCell* c : around) {
+                if (c->surface <= -500.0f) continue;
+                surface += c->surface;
+                ground += c->ground;
+                wet++;
+                if (c->flowDir < 8) {
+                    flowX += cosf(c->flowDir * 0.785398f);
+                    flowZ += sinf(c->flowDir * 0.785398f);
+                }
+            }
+            if (wet > 0) {
+                surface /= wet;
+                ground /= wet;
+            }
+            // Flow directions of the tiles sharing the corner are averaged as vectors
+            float flowAngle = 0.0f;
+            if (flowX != 0.0f || flowZ != 0.0f) {
+                flowAngle = atan2f(flowZ, flowX);
+                if (flowAngle < 0.0f) flowAngle += twoPi;
+            }
+
+            int v = cy * (width + 1) + cx;
+            out.vertices[v*3+0] = (float)cx;
+            out.vertices[v*3+1] = surface;
+            out.vertices[v*3+2] = (float)cy;
+            out.normals[v*3+0] = 0.0f;
+            out.normals[v*3+1] = 1.0f;
+            out.normals[v*3+2] = 0.0f;
+            // Pack underlying terrain height in texcoord.x for depth calculation
+            out.texcoords[v*2+0] = ground;
+            // Pack flow direction angle in texcoord.y for river animation
+            out.texcoords[v*2+1] = flowAngle;
         }
     }
+}
 
-    int vertexCount = (int)vertices.size();
-    int triangleCount = vertexCount / 3;
+// Emit the indices of the water quads in tile row y (nothing for dry tiles)
+void tileGrid::emitWaterRow(int y, std::pmr::vector<unsigned short>& out) {
+    for (int x = 0; x < width; ++x) {
+        if (waterCellAt(x, y).surface <= -500.0f) continue;
 
-    // Initialize empty mesh
-    waterMesh = {0};
-    Color tint = { 40, 120, 220, 140 };
+        // Corner layout:  0--1  (NW--NE)  z=y
+        //                 |  |
+        //                 3--2  (SW--SE)  z=y+1
+        unsigned short c0 = (unsigned short)(y * (width + 1) + x);
+        unsigned short c1 = c0 + 1;
+        unsigned short c3 = (unsigned short)(c0 + width + 1);
+        unsigned short c2 = c3 + 1;
+
+        // Draw full quad as two triangles
+        out.insert(out.end(), {c2, c1, c0, c0, c3, c2});
+    }
+}
+
+// Copy a row into its index range, padding the slack with degenerate triangles
+void tileGrid::writeWaterRow(WaterMeshData& out, const MeshRowSpan& span, const std::pmr::vector<unsigned short>& row) {
+    unsigned short* dst = out.indices.data() + span.offset;
+    std::copy(row.begin(), row.end(), dst);
+    std::fill(dst + row.size(), dst + span.capacity, (unsigned short)0);
+}
+
+// Build a separate flat translucent water surface model
+// Rivers and lakes use full tile quads - the carved terrain provides the banks
+void tileGrid::generateWaterMesh() {
+    WaterMeshData data;
+    buildWaterMeshData(data);
+    uploadWaterMesh(std::move(data));
+}
+
+void tileGrid::buildWaterMeshData(WaterMeshData& out) {
+    PROFILE_SCOPE("tileGrid::buildWaterMeshData");
+    out.clear();
+    waterEdgeDirty = false;
+
+    // One pass over the chunk and its border ring; every water height is derived once
+    waterCells.assign((width + 2) * (height + 2), WaterCell{});
+    buildWaterCells(-1, height + 1);
+
+    ScratchScope scratch;
+    std::pmr::vector<std::pmr::vector<unsigned short>> rows(height, scratch.resource());
+    int emitted = 0;
+    for (int y = 0; y < height; ++y) {
+        emitWaterRow(y, rows[y]);
+        emitted += (int)rows[y].size();
+    }
+
+    // Dry chunks get no mesh; patchWaterRows() asks for a rebuild once water appears
+    if (emitted == 0) return;
+
+    // Lay index rows out back to back with slack, like the terrain mesh
+    out.rows.assign(height, MeshRowSpan{});
+    int indexCount = 0;
+    for (int y = 0; y < height; ++y) {
+        MeshRowSpan& span = out.rows[y];
+        span.offset = indexCount;
+        span.count = (int)rows[y].size();
+        span.capacity = span.count + WATER_ROW_SLACK;
+        indexCount += span.capacity;
+    }
+    int vertexCount = (width + 1) * (height + 1);
+
+    // Positions, normals, and texcoords.x for base height
+    out.vertices.resize(vertexCount * 3);
+    out.normals.resize(vertexCount * 3);
+    out.texcoords.resize(vertexCount * 2);
+    out.indices.resize(indexCount);
+
+    writeWaterCorners(out, 0, height + 1);
+    for (int y = 0; y < height; ++y) {
+        writeWaterRow(out, out.rows[y], rows[y]);
+    }
+}
+
+void tileGrid::uploadWaterMesh(WaterMeshData&& data) {
+    PROFILE_SCOPE("tileGrid::uploadWaterMesh");
+    // Swap so the caller's (old) buffers keep their capacity for the next build
+    std::swap(waterData, data);
+    // A dry chunk keeps any existing model for reuse; hasWater() hides it
+    if (waterData.empty()) return;
+
+    int vertexCount = (int)waterData.vertices.size() / 3;
+    int indexCount = (int)waterData.indices.size();
+
+    if (waterModelLoaded && vertexCount == waterMesh.vertexCount && indexCount <= waterIndexCapacity) {
+        // The corner grid never changes size, so usually only the indices can outgrow the buffers
+        UpdateMeshBuffer(waterMesh, 0, waterData.vertices.data(), vertexCount * 3 * sizeof(float), 0);
+        UpdateMeshBuffer(waterMesh, 1, waterData.texcoords.data(), vertexCount * 2 * sizeof(float), 0);
+        UpdateMeshBuffer(waterMesh, 2, waterData.normals.data(), vertexCount * 3 * sizeof(float), 0);
+        UpdateMeshBuffer(waterMesh, RL_DEFAULT_SHADER_ATTRIB_LOCATION_INDICES, waterData.indices.data(),
+                         indexCount * sizeof(unsigned short), 0);
+        PROFILE_COUNT("gl buffer refills", 4);
+    } else {
+        unloadWaterModel();
 
-    if (vertexCount == 0) {
-        // Create an empty model for chunks with no water
+        // Allocate the index buffer with headroom (whole triangles); UploadMesh
+        // sizes it from triangleCount, so pad the CPU copy while uploading
+        waterIndexCapacity = indexCount + (indexCount / 4) / 3 * 3;
+        waterData.indices.resize(waterIndexCapacity, 0);
+
+        waterMesh = {0};
+        waterMesh.vertexCount = vertexCount;
+        waterMesh.triangleCount = waterIndexCapacity / 3;
+        waterMesh.vertices = waterData.vertices.data();
+        waterMesh.normals = waterData.normals.data();
+        waterMesh.texcoords = waterData.texcoords.data();
+        waterMesh.indices = waterData.indices.data();
+        UploadMesh(&waterMesh, true);
+        waterData.indices.resize(indexCount);
+        PROFILE_COUNT("gl objects created", 5);  // VAO + position, texcoord, normal, index buffers
+
+        // Create model and set translucent blue color
+        Color tint = { 40, 120, 220, 140 };
         waterModel = LoadModelFromMesh(waterMesh);
         for (int i = 0; i < waterModel.materialCount; ++i) {
             waterModel.materials[i].maps[MATERIAL_MAP_DIFFUSE].color = tint;
@@ -798,37 +1382,84 @@ void tileGrid::generateWaterMesh() {
             waterModel.materials[i].maps[MATERIAL_MAP_NORMAL].texture = resourceManager::waterDisplacementTexture; // Use normal map slot for displacement
             waterModel.materials[i].shader = resourceManager::getShader(1);
         }
-        return;
+        waterModelLoaded = true;
     }
 
-    // Allocate arrays (positions, normals, and use texcoords.x for base height)
-    waterMesh.vertexCount = vertexCount;
-    waterMesh.triangleCount = triangleCount;
-    waterMesh.vertices = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
-    waterMesh.normals  = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
-    waterMesh.texcoords = (float*)MemAlloc(vertexCount * 2 * sizeof(float));
-
-    for (int i = 0; i < vertexCount; ++i) {
-        waterMesh.vertices[i*3+0] = vertices[i].x;
-        waterMesh.vertices[i*3+1] = vertices[i].y;
-        waterMesh.vertices[i*3+2] = vertices[i].z;
-        waterMesh.normals[i*3+0] = normals[i].x;
-        waterMesh.normals[i*3+1] = normals[i].y;
-        waterMesh.normals[i*3+2] = normals[i].z;
-        // Pack underlying terrain height in texcoord.x for depth calculation
-        waterMesh.texcoords[i*2+0] = baseHeights[i];
-        // Pack flow direction angle in texcoord.y for river animation
-        waterMesh.texcoords[i*2+1] = flowDirs[i];
-    }
-
-    UploadMesh(&waterMesh, true);
-
-    // Create model and set translucent blue color
-    waterModel = LoadModelFromMesh(waterMesh);
-    for (int i = 0; i < waterModel.materialCount; ++i) {
-        waterModel.materials[i].maps[MATERIAL_MAP_DIFFUSE].color = tint;
-        waterModel.materials[i].maps[MATERIAL_MAP_DIFFUSE].texture = resourceManager::waterTexture;
-        waterModel.materials[i].maps[MATERIAL_MAP_NORMAL].texture = resourceManager::waterDisplacementTexture; // Use normal map slot for displacement
-        waterModel.materials[i].shader = resourceManager::getShader(1);
+    // The Mesh borrows waterData's arrays (never owns them). DrawMesh only
+    // takes the indexed path while indices is non-null, and only the
+    // uploaded indices are drawn.
+    waterMesh.triangleCount = indexCount / 3;
+    waterMesh.vertices = waterData.vertices.data();
+    waterMesh.normals = waterData.normals.data();
+    waterMesh.texcoords = waterData.texcoords.data();
+    waterMesh.indices = waterData.indices.data();
+    waterModel.meshes[0] = waterMesh;
+    updateWaterTop();
+}
+
+void tileGrid::updateWaterTop() {
+    waterTop = -FLT_MAX;
+    for (size_t i = 1; i < waterData.vertices.size(); i += 3) {
+        waterTop = std::max(waterTop, waterData.vertices[i]);
     }
 }
+
+// Release the water model without letting raylib free the borrowed CPU arrays
+void tileGrid::unloadWaterModel() {
+    if (!waterModelLoaded) return;
+    Mesh& mesh = waterModel.meshes[0];
+    mesh.vertices = nullptr;
+    mesh.normals = nullptr;
+    mesh.texcoords = nullptr;
+    mesh.indices = nullptr;
+    UnloadModel(waterModel);
+    PROFILE_COUNT("gl objects deleted", 5);
+    waterMesh = {0};
+    waterModelLoaded = false;
+    waterIndexCapacity = 0;
+}
+
+// Water counterpart of patchTerrainRows. A chunk without any water has no
+// row layout; it only needs a rebuild once an edit actually adds water.
+bool tileGrid::patchWaterRows(int rowBegin, int rowEnd) {
+    if (waterCells.empty()) return false;
+    // Corner rows 0 and height also average the north / south neighbours'
+    // cells in the padding rows, which are only filled here and by full
+    // builds (run before the chunk is linked, so they start out dry)
+    buildWaterCells(rowBegin == 0 ? -1 : rowBegin, rowEnd == height ? height + 1 : rowEnd);
+
+    if (waterData.empty()) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (waterCellAt(x, y).surface > -500.0f) return false;
+            }
+        }
+        return true;
+    }
+
+    ScratchScope scratch;
+    std::pmr::vector<unsigned short> row(scratch.resource());
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        row.clear();
+        emitWaterRow(y, row);
+        MeshRowSpan& span = waterData.rows[y];
+        if ((int)row.size() > span.capacity) return false;
+        writeWaterRow(waterData, span, row);
+        span.count = (int)row.size();
+    }
+
+    // Corner rows [rowBegin, rowEnd] touch the refreshed tiles. Normals are
+    // always up, so only positions and texcoords need uploading.
+    writeWaterCorners(waterData, rowBegin, rowEnd + 1);
+    updateWaterTop();
+    int firstVertex = rowBegin * (width + 1);
+    int vertexCount = (rowEnd + 1 - rowBegin) * (width + 1);
+    UpdateMeshBuffer(waterMesh, 0, waterData.vertices.data() + firstVertex * 3, vertexCount * 3 * sizeof(float), firstVertex * 3 * sizeof(float));
+    UpdateMeshBuffer(waterMesh, 1, waterData.texcoords.data() + firstVertex * 2, vertexCount * 2 * sizeof(float), firstVertex * 2 * sizeof(float));
+
+    int first = waterData.rows[rowBegin].offset;
+    int count = waterData.rows[rowEnd - 1].offset + waterData.rows[rowEnd - 1].capacity - first;
+    UpdateMeshBuffer(waterMesh, RL_DEFAULT_SHADER_ATTRIB_LOCATION_INDICES, waterData.indices.data() + first,
+                     count * sizeof(unsigned short), first * sizeof(unsigned short));
+    return true;
+}
@@ -0,0 +1,88 @@
+#include "../include/workerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void WorkerPool::submit(uint64_t id, float priority, Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({id, priority, std::move(job)});
+    }
+    wake.notify_one();
+}
+
+bool WorkerPool::cancel(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(queue.begin(), queue.end(), [id](const Entry& e) { return e.id == id; });
+    if (it == queue.end()) return false;
+    queue.erase(it);
+    return true;
+}
+
+void WorkerPool::reprioritize(const std::function<float(uint64_t id)>& priorityOf) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Entry& e : queue) {
+        e.priority = priorityOf(e.id);
+    }
+}
+
+void WorkerPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && active == 0; });
+}
+
+size_t WorkerPool::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
+int WorkerPool::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return active;
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+
+            auto best = std::max_element(queue.begin(), queue.end(), [](const Entry& a, const Entry& b) {
+                return a.priority < b.priority;
+            });
+            job = std::move(best->job);
+            queue.erase(best);
+            active++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active--;
+        }
+        idle.notify_all();
+    }
+}
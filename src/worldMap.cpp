@@ -104,12 +104,9 @@ RegionData& WorldMap::getRegion(int worldX, int worldZ) {
 }
 
 void WorldMap::ensureRegionReady(RegionData& region) {
-    if (!region.heightsGenerated) {
-        generateHeights(region);
-    }
-    if (!region.eroded) {
-        applyErosion(region);
-    }
+    ensureRegionTerrain(region);
+
+    std::lock_guard<std::mutex> lock(region.dataMutex);
     if (!region.potentialsGenerated) {
         generatePotentials(region);
     }
@@ -118,15 +115,19 @@ void WorldMap::ensureRegionReady(RegionData& region) {
     }
 }
 
-float WorldMap::getHeight(float worldX, float worldZ) {
-    RegionData& region = getRegion(static_cast<int>(worldX), static_cast<int>(worldZ));
-    
+void WorldMap::ensureRegionTerrain(RegionData& region) {
+    std::lock_guard<std::mutex> lock(region.terrainMutex);
     if (!region.heightsGenerated) {
         generateHeights(region);
     }
     if (!region.eroded) {
         applyErosion(region);
     }
+}
+
+float WorldMap::getHeight(float worldX, float worldZ) {
+    RegionData& region = getRegion(static_cast<int>(worldX), static_cast<int>(worldZ));
+    ensureRegionTerrain(region);
     
     float localX = worldX - region.worldX;
     float localZ = worldZ - region.worldZ;
@@ -134,7 +135,7 @@ float WorldMap::getHeight(float worldX, float worldZ) {
 }
 
 void WorldMap::getHeightGrid(
-    std::vector<float>& out,
+    std::pmr::vector<float>& out,
     int chunkWorldX, int chunkWorldZ,
     int width, int height
 ) {
@@ -151,7 +152,7 @@ void WorldMap::getHeightGrid(
 }
 
 void WorldMap::getPotentialGrid(
-    std::vector<PotentialData>& out,
+    std::pmr::vector<PotentialData>& out,
     int chunkWorldX, int chunkWorldZ,
     int width, int height
 ) {
@@ -175,7 +176,7 @@ void WorldMap::getPotentialGrid(
 }
 
 void WorldMap::getWaterGrid(
-    std::vector<float>& out,
+    std::pmr::vector<float>& out,
     int chunkWorldX, int chunkWorldZ,
     int width, int height
 ) {
@@ -199,8 +200,8 @@ void WorldMap::getWaterGrid(
 }
 
 void WorldMap::getRiverGrid(
-    std::vector<uint8_t>& flowDirOut,
-    std::vector<uint8_t>& riverWidthOut,
+    std::pmr::vector<uint8_t>& flowDirOut,
+    std::pmr::vector<uint8_t>& riverWidthOut,
     int chunkWorldX, int chunkWorldZ,
     int width, int height
 ) {
@@ -228,7 +229,7 @@ void WorldMap::getRiverGrid(
 }
 
 void WorldMap::getErosionGrid(
-    std::vector<uint8_t>& erosionOut,
+    std::pmr::vector<uint8_t>& erosionOut,
     int chunkWorldX, int chunkWorldZ,
     int width, int height
 ) {
@@ -532,7 +533,7 @@ void WorldMap::generatePotentials(RegionData& region) {
 
 void WorldMap::generateWater(RegionData& region) {
     if (!region.heightsGenerated || !region.eroded) {
-        ensureRegionReady(region);
+        ensureRegionTerrain(region);
     }
     
     const int W = region.width;